@@ -0,0 +1,371 @@
+#include "Benchmark.h"
+#include "../Game/Game.h"
+#include "../Input/Input.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+	GameBoard::UnsignedUnit CountAliveCells(const GameBoard::IGameBoard& gameBoard)
+	{
+		GameBoard::UnsignedUnit population = 0;
+		GameBoard::ForEachAliveCell(gameBoard, [&population](const GameBoard::Coord&) { ++population; });
+		return population;
+	}
+
+	/// <summary>
+	/// A square of random cells with its top left corner at (offset, offset). Uses its own generator rather than anything in <random> so
+	/// the soup is the same on every compiler.
+	/// </summary>
+	void LoadSoup(GameBoard::IGameBoard& gameBoard, GameBoard::Unit size, unsigned densityPercent, GameBoard::Unit offset = 0)
+	{
+		std::vector<GameBoard::Coord> cells;
+		uint64_t random = 0x5EED;
+		for (GameBoard::Unit y = 0; y < size; ++y)
+		{
+			for (GameBoard::Unit x = 0; x < size; ++x)
+			{
+				random = random * 6364136223846793005ull + 1442695040888963407ull;
+				if ((random >> 33) % 100 < densityPercent)
+				{
+					cells.push_back({ offset + x, offset + y });
+				}
+			}
+		}
+
+		gameBoard.SetCells(cells, true);
+		gameBoard.FinishCurrentGeneration();
+	}
+
+	void LoadCells(GameBoard::IGameBoard& gameBoard, std::span<const GameBoard::Coord> cells)
+	{
+		gameBoard.SetCells(cells, true);
+		gameBoard.FinishCurrentGeneration();
+	}
+
+	void LoadRle(GameBoard::IGameBoard& gameBoard, const char* rle)
+	{
+		std::istringstream stream(rle);
+		Input::CreateGameFromRleStream(stream, gameBoard);
+	}
+
+	/// <summary>
+	/// A diagonal line like the TheLine stress test, a tenth as long so the slow boards finish in seconds. It only ever loses a cell off
+	/// each end, so nearly all the cost is in how a board copes with a huge, almost empty area.
+	/// </summary>
+	void LoadLine(GameBoard::IGameBoard& gameBoard)
+	{
+		std::vector<GameBoard::Coord> line;
+		line.reserve(100000);
+		for (GameBoard::Unit i = 0; i < 100000; ++i)
+		{
+			line.push_back({ i, i });
+		}
+		LoadCells(gameBoard, line);
+	}
+
+	constexpr GameBoard::Coord rPentomino[] = { { 1, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 }, { 1, 2 } };
+
+	//The smallest pattern that grows forever, it turns into a switch engine that lays blocks behind it as it heads off diagonally
+	constexpr GameBoard::Coord switchEngine[] = { { 6, 0 }, { 4, 1 }, { 6, 1 }, { 7, 1 }, { 4, 2 }, { 6, 2 }, { 4, 3 }, { 2, 4 }, { 0, 5 }, { 2, 5 } };
+
+	constexpr const char* gosperGliderGun =
+		"#N Gosper glider gun\n"
+		"x = 36, y = 9, rule = B3/S23\n"
+		"24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4bo\n"
+		"bo$10bo5bo7bo$11bo3bo$12b2o!\n";
+
+	/// <summary>
+	/// Where the value at a fraction of the way through sorted samples would be, drawing a line between the two samples either side
+	/// </summary>
+	double Percentile(const std::vector<double>& sortedSamples, double fraction)
+	{
+		if (sortedSamples.empty())
+		{
+			return 0;
+		}
+
+		const double position = fraction * static_cast<double>(sortedSamples.size() - 1);
+		const size_t below = static_cast<size_t>(position);
+		const size_t above = std::min(below + 1, sortedSamples.size() - 1);
+		return sortedSamples[below] + (sortedSamples[above] - sortedSamples[below]) * (position - static_cast<double>(below));
+	}
+
+	void WriteJsonString(std::ostream& stream, const std::string& value)
+	{
+		stream << '"';
+		for (const char character : value)
+		{
+			if (character == '"' || character == '\\')
+			{
+				stream << '\\';
+			}
+			stream << character;
+		}
+		stream << '"';
+	}
+
+	/// <summary>
+	/// The preallocated board has to know where the pattern starts before it can be made, so the workload gets loaded onto a board that
+	/// doesn't care first to find out
+	/// </summary>
+	GameBoard::IGameBoardPtr CreatePreallocatedGridBoard(const Benchmark::Workload& workload)
+	{
+		GameBoard::IGameBoardPtr scratchBoard = GameBoard::CreateHashLifeBoard();
+		workload.load(*scratchBoard);
+
+		GameBoard::Coord min, max;
+		if (!scratchBoard->GetBoundingBox(min, max))
+		{
+			return nullptr;
+		}
+		return GameBoard::CreatePreallocatedGridBoard(min, max, workload.generations);
+	}
+
+	/// <summary>
+	/// A line under a result saying what share of the counting run each phase took, to tell step bound workloads from bookkeeping bound ones
+	/// </summary>
+	void PrintPhases(std::ostream& output, const Benchmark::Result& result)
+	{
+		GameBoard::UnsignedUnit totalNanoseconds = 0;
+		for (const GameBoard::Instrumentation::PhaseTotals& totals : result.phases)
+		{
+			totalNanoseconds += totals.nanoseconds;
+		}
+
+		output << "    ";
+		for (size_t phase = 0; phase < GameBoard::Instrumentation::phaseCount; ++phase)
+		{
+			if (result.phases[phase].calls != 0)
+			{
+				const double percent = totalNanoseconds == 0 ? 0.0 : 100.0 * result.phases[phase].nanoseconds / totalNanoseconds;
+				output << GameBoard::Instrumentation::PhaseName(static_cast<GameBoard::Instrumentation::Phase>(phase)) << " "
+					<< std::fixed << std::setprecision(1) << percent << "%  ";
+			}
+		}
+		output << "peak " << result.peakBytesResident << " bytes" << std::endl;
+	}
+}
+
+double Benchmark::Result::GenerationsPerSecond() const
+{
+	return medianMilliseconds > 0 ? static_cast<double>(generations) * 1000.0 / medianMilliseconds : 0;
+}
+
+double Benchmark::Result::CellsPerSecond() const
+{
+	return medianMilliseconds > 0 ? static_cast<double>(cellGenerations) * 1000.0 / medianMilliseconds : 0;
+}
+
+Benchmark::BenchmarkEngine::BenchmarkEngine()
+{
+	//The simple alive cell list can't step, and the 6x6 static grid is too small to hold any of the workloads, so neither is here.
+	//Everything else is, along with the multi grid over each tile size the adaptive board can pick from. The preallocated board is made
+	//to fit each workload, and sits out any it would need too much memory for.
+	m_boardTypes =
+	{
+		{ "MultiGrid_Static6", [](const Workload&) { return GameBoard::CreateMultiGridBoard(&GameBoard::CreateStaticGridBoard6); }, 0 },
+		{ "MultiGrid_Simd62", [](const Workload&) { return GameBoard::CreateMultiGridBoard(&GameBoard::CreateSimdGridBoard62); }, 0 },
+		{ "MultiGrid_Simd254", [](const Workload&) { return GameBoard::CreateMultiGridBoard(&GameBoard::CreateSimdGridBoard); }, 0 },
+		{ "MultiGrid_Simd1022", [](const Workload&) { return GameBoard::CreateMultiGridBoard(&GameBoard::CreateSimdGridBoard1022); }, 0 },
+		{ "MultiGrid_Simd254_Threaded", [](const Workload&) { return GameBoard::CreateMultiGridBoard(&GameBoard::CreateSimdGridBoard, 0); }, 0 },
+		{ "Adaptive", [](const Workload&) { return GameBoard::CreateAdaptiveGridBoard(); }, 0 },
+		{ "HashLife", [](const Workload&) { return GameBoard::CreateHashLifeBoard(); }, 0 },
+		{ "Simd254", [](const Workload&) { return GameBoard::CreateSimdGridBoard(); }, 254 },
+		{ "Preallocated", [](const Workload& workload) { return CreatePreallocatedGridBoard(workload); }, 0 },
+	};
+
+	m_workloads =
+	{
+		//Gliders leave a soup at a quarter of a cell a generation, so this one sits in the middle of a single 254 tile with room for them
+		{ "Soup128_35", [](GameBoard::IGameBoard& gameBoard) { LoadSoup(gameBoard, 128, 35, 63); }, 200, 241 },
+		{ "Soup240_35", [](GameBoard::IGameBoard& gameBoard) { LoadSoup(gameBoard, 240, 35); }, 500, 0 },
+		{ "Soup1024_10", [](GameBoard::IGameBoard& gameBoard) { LoadSoup(gameBoard, 1024, 10); }, 100, 1024 },
+		{ "Soup1024_35", [](GameBoard::IGameBoard& gameBoard) { LoadSoup(gameBoard, 1024, 35); }, 100, 1024 },
+		{ "Soup1024_60", [](GameBoard::IGameBoard& gameBoard) { LoadSoup(gameBoard, 1024, 60); }, 100, 1024 },
+		{ "RPentomino", [](GameBoard::IGameBoard& gameBoard) { LoadCells(gameBoard, rPentomino); }, 1103, 0 },
+		{ "GosperGliderGun", [](GameBoard::IGameBoard& gameBoard) { LoadRle(gameBoard, gosperGliderGun); }, 2000, 0 },
+		{ "SwitchEngine", [](GameBoard::IGameBoard& gameBoard) { LoadCells(gameBoard, switchEngine); }, 2000, 0 },
+		{ "TheLine", [](GameBoard::IGameBoard& gameBoard) { LoadLine(gameBoard); }, 100, 100000 },
+	};
+
+	//The patterns that run off to infinity need room for how far they get
+	for (Workload& workload : m_workloads)
+	{
+		if (workload.extent == 0)
+		{
+			workload.extent = static_cast<GameBoard::Unit>(workload.generations);
+		}
+	}
+}
+
+std::vector<Benchmark::Result> Benchmark::BenchmarkEngine::RunAll(std::ostream& output, const Options& options) const
+{
+	output << std::left << std::setw(28) << "Board" << std::setw(18) << "Workload" << std::right
+		<< std::setw(12) << "Median ms" << std::setw(12) << "P10 ms" << std::setw(12) << "P90 ms"
+		<< std::setw(14) << "Gens/s" << std::setw(16) << "Cells/s" << std::setw(12) << "Peak KB" << std::setw(10) << "B/cell" << std::endl;
+
+	std::vector<Result> results;
+	for (const Workload& workload : m_workloads)
+	{
+		for (const BoardType& boardType : m_boardTypes)
+		{
+			if (boardType.maximumExtent != 0 && workload.extent > boardType.maximumExtent)
+			{
+				continue;
+			}
+			if (!options.filter.empty() && boardType.name.find(options.filter) == std::string::npos && workload.name.find(options.filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			GameBoard::IGameBoardPtr gameBoard = boardType.create(workload);
+			if (!gameBoard)
+			{
+				continue;
+			}
+
+			const Result& result = results.emplace_back(Run(boardType, *gameBoard, workload, options));
+			output << std::left << std::setw(28) << result.board << std::setw(18) << result.workload << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(12) << result.medianMilliseconds << std::setw(12) << result.p10Milliseconds << std::setw(12) << result.p90Milliseconds
+				<< std::setprecision(0) << std::setw(14) << result.GenerationsPerSecond() << std::setw(16) << result.CellsPerSecond()
+				<< std::setw(12) << result.peakBytes / 1024 << std::setprecision(1) << std::setw(10) << result.bytesPerLiveCell << std::endl;
+
+			if constexpr (GameBoard::Instrumentation::enabled)
+			{
+				PrintPhases(output, result);
+			}
+		}
+	}
+
+	//Every board runs the same patterns, so they had all better end up with the same number of cells
+	std::map<std::string, const Result*> firstResults;
+	for (const Result& result : results)
+	{
+		auto [firstResult, inserted] = firstResults.emplace(result.workload, &result);
+		if (!inserted && firstResult->second->finalPopulation != result.finalPopulation)
+		{
+			output << "WARNING: " << result.board << " ended " << result.workload << " with " << result.finalPopulation << " cells, but "
+				<< firstResult->second->board << " ended it with " << firstResult->second->finalPopulation << std::endl;
+		}
+	}
+
+	return results;
+}
+
+Benchmark::Result Benchmark::BenchmarkEngine::Run(const BoardType& boardType, GameBoard::IGameBoard& gameBoard, const Workload& workload, const Options& options) const
+{
+	Result result;
+	result.board = boardType.name;
+	result.workload = workload.name;
+	result.generations = workload.generations;
+
+	const GameBoard::RuleMasks& rule = Game::GameOfLifeRule();
+
+	//The first run isn't timed, it counts how much work there is to do, which would throw the timing off. It's also the run that gets
+	//broken down by phase in instrumented builds, since getting the records walks the board every generation.
+	gameBoard.Clear();
+	GameBoard::Memory::ResetPeaks();
+	const GameBoard::Memory::Usage memoryBeforeRun = GameBoard::Memory::GetTotalUsage();
+	workload.load(gameBoard);
+	GameBoard::Instrumentation::Reset();
+	GameBoard::Instrumentation::SetGenerationRecordFn([&result](const GameBoard::Instrumentation::GenerationRecord& record)
+		{
+			for (size_t phase = 0; phase < GameBoard::Instrumentation::phaseCount; ++phase)
+			{
+				result.phases[phase].nanoseconds += record.phases[phase].nanoseconds;
+				result.phases[phase].calls += record.phases[phase].calls;
+			}
+			result.peakBytesResident = std::max(result.peakBytesResident, record.bytesResident);
+		});
+	for (GameBoard::UnsignedUnit generation = 0; generation < workload.generations; ++generation)
+	{
+		result.cellGenerations += CountAliveCells(gameBoard);
+		Game::RunGeneration(gameBoard, rule);
+	}
+	GameBoard::Instrumentation::SetGenerationRecordFn(nullptr);
+	result.finalPopulation = CountAliveCells(gameBoard);
+
+	const GameBoard::Memory::Usage memoryAfterRun = GameBoard::Memory::GetTotalUsage();
+	result.peakBytes = memoryAfterRun.peakBytes;
+	result.allocations = memoryAfterRun.allocations - memoryBeforeRun.allocations;
+	result.bytesPerLiveCell = result.finalPopulation == 0 ? 0.0 : static_cast<double>(memoryAfterRun.liveBytes) / result.finalPopulation;
+
+	for (unsigned run = 0; run < options.warmupRuns + options.trials; ++run)
+	{
+		gameBoard.Clear();
+		workload.load(gameBoard);
+
+		//All the generations in one go, so boards that can jump ahead like hashlife get timed doing it. Everything else steps them
+		//one at a time anyway.
+		const auto timeBeforeRun = std::chrono::steady_clock::now();
+		Game::RunGenerations(gameBoard, rule, workload.generations);
+		const auto timeAfterRun = std::chrono::steady_clock::now();
+
+		if (run >= options.warmupRuns)
+		{
+			result.trialMilliseconds.push_back(std::chrono::duration<double, std::milli>(timeAfterRun - timeBeforeRun).count());
+		}
+	}
+
+	std::sort(result.trialMilliseconds.begin(), result.trialMilliseconds.end());
+	result.medianMilliseconds = Percentile(result.trialMilliseconds, 0.5);
+	result.p10Milliseconds = Percentile(result.trialMilliseconds, 0.1);
+	result.p90Milliseconds = Percentile(result.trialMilliseconds, 0.9);
+	return result;
+}
+
+void Benchmark::BenchmarkEngine::WriteJson(std::ostream& stream, const Options& options, const std::vector<Result>& results)
+{
+	stream << std::setprecision(6) << std::defaultfloat;
+	stream << "{\n";
+	stream << "  \"warmupRuns\": " << options.warmupRuns << ",\n";
+	stream << "  \"trials\": " << options.trials << ",\n";
+	stream << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+	stream << "  \"results\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+		stream << (i == 0 ? "\n" : ",\n") << "    {\n";
+		stream << "      \"board\": ";
+		WriteJsonString(stream, result.board);
+		stream << ",\n      \"workload\": ";
+		WriteJsonString(stream, result.workload);
+		stream << ",\n      \"generations\": " << result.generations;
+		stream << ",\n      \"trialMilliseconds\": [";
+		for (size_t trial = 0; trial < result.trialMilliseconds.size(); ++trial)
+		{
+			stream << (trial == 0 ? "" : ", ") << result.trialMilliseconds[trial];
+		}
+		stream << "],\n      \"medianMilliseconds\": " << result.medianMilliseconds;
+		stream << ",\n      \"p10Milliseconds\": " << result.p10Milliseconds;
+		stream << ",\n      \"p90Milliseconds\": " << result.p90Milliseconds;
+		stream << ",\n      \"generationsPerSecond\": " << result.GenerationsPerSecond();
+		stream << ",\n      \"cellsPerSecond\": " << result.CellsPerSecond();
+		stream << ",\n      \"cellGenerations\": " << result.cellGenerations;
+		stream << ",\n      \"finalPopulation\": " << result.finalPopulation;
+		stream << ",\n      \"peakBytes\": " << result.peakBytes;
+		stream << ",\n      \"allocations\": " << result.allocations;
+		stream << ",\n      \"bytesPerLiveCell\": " << result.bytesPerLiveCell;
+		if constexpr (GameBoard::Instrumentation::enabled)
+		{
+			stream << ",\n      \"peakBytesResident\": " << result.peakBytesResident;
+			stream << ",\n      \"phases\": {";
+			for (size_t phase = 0; phase < GameBoard::Instrumentation::phaseCount; ++phase)
+			{
+				stream << (phase == 0 ? "" : ",") << "\n        ";
+				WriteJsonString(stream, GameBoard::Instrumentation::PhaseName(static_cast<GameBoard::Instrumentation::Phase>(phase)));
+				stream << ": { \"milliseconds\": " << result.phases[phase].nanoseconds / 1e6 << ", \"calls\": " << result.phases[phase].calls << " }";
+			}
+			stream << "\n      }";
+		}
+		stream << "\n    }";
+	}
+
+	stream << (results.empty() ? "]\n" : "\n  ]\n") << "}\n";
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "../GameBoard/GameBoardInterface.h"
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+	/// <summary>
+	/// A pattern to run and how many generations to run it for. Loading the pattern is never part of the time.
+	/// </summary>
+	struct Workload
+	{
+		std::string name;
+
+		//Sets the cells and finishes the generation, the same as loading a file would
+		std::function<void(GameBoard::IGameBoard&)> load;
+
+		GameBoard::UnsignedUnit generations;
+
+		//How far from the origin the pattern gets over the run, so bounded boards that can't hold it get skipped. Bounded boards start at
+		//the origin, so a pattern only fits if it also never goes negative.
+		GameBoard::Unit extent;
+	};
+
+	struct BoardType
+	{
+		std::string name;
+
+		//Gets told the workload for boards that have to be sized to it up front. Returns nullptr if the board can't run the workload.
+		std::function<GameBoard::IGameBoardPtr(const Workload&)> create;
+
+		//The most cells across the board can hold, 0 if it has no limit
+		GameBoard::Unit maximumExtent;
+	};
+
+	struct Options
+	{
+		//Runs before the timed ones, to get the caches, the pools and the branch predictor warmed up
+		unsigned warmupRuns = 1;
+		unsigned trials = 5;
+
+		//Only run boards or workloads with this in their name, everything if it's empty
+		std::string filter;
+	};
+
+	struct Result
+	{
+		std::string board;
+		std::string workload;
+		GameBoard::UnsignedUnit generations = 0;
+
+		//Every timed run in order from fastest to slowest
+		std::vector<double> trialMilliseconds;
+		double medianMilliseconds = 0;
+		double p10Milliseconds = 0;
+		double p90Milliseconds = 0;
+
+		//The live cells summed over every generation stepped, which is how much work the board actually had to do
+		GameBoard::UnsignedUnit cellGenerations = 0;
+
+		//Every board should agree on this, if they don't one of them is wrong
+		GameBoard::UnsignedUnit finalPopulation = 0;
+
+		//What the board allocated during the counting run: the most it held at once, how many allocations it made, and what it was
+		//holding per live cell at the end
+		GameBoard::UnsignedUnit peakBytes = 0;
+		GameBoard::UnsignedUnit allocations = 0;
+		double bytesPerLiveCell = 0;
+
+		//Only filled in when built with GOL_INSTRUMENTATION: where the untimed counting run spent its time, and the most memory the board held
+		GameBoard::Instrumentation::PhaseTotals phases[GameBoard::Instrumentation::phaseCount];
+		GameBoard::UnsignedUnit peakBytesResident = 0;
+
+		double GenerationsPerSecond() const;
+		double CellsPerSecond() const;
+	};
+
+	/// <summary>
+	/// Runs a fixed set of workloads on every board type we have and reports how long they took. Unlike the tests this doesn't check
+	/// answers against disk, it runs each pair several times and reports the spread, so results can be compared between builds.
+	/// </summary>
+	class BenchmarkEngine
+	{
+	public:
+		BenchmarkEngine();
+
+		/// <summary>
+		/// Runs every board against every workload that fits on it, printing a line per pair as it goes
+		/// </summary>
+		std::vector<Result> RunAll(std::ostream& output, const Options& options) const;
+
+		/// <summary>
+		/// Writes the results out as JSON, one object per board and workload pair, for keeping around and diffing against later runs
+		/// </summary>
+		static void WriteJson(std::ostream& stream, const Options& options, const std::vector<Result>& results);
+
+	private:
+		Result Run(const BoardType& boardType, GameBoard::IGameBoard& gameBoard, const Workload& workload, const Options& options) const;
+
+		std::vector<BoardType> m_boardTypes;
+		std::vector<Workload> m_workloads;
+	};
+}
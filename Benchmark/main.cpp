@@ -0,0 +1,74 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::cout << "Usage: benchmark [--trials N] [--warmup N] [--filter NAME] [--json FILE]" << std::endl;
+		std::cout << "    --trials N     Timed runs of each board and workload, default 5" << std::endl;
+		std::cout << "    --warmup N     Untimed runs before those, default 1" << std::endl;
+		std::cout << "    --filter NAME  Only run boards or workloads with NAME in their name" << std::endl;
+		std::cout << "    --json FILE    Also write the results to FILE as JSON, - for standard output" << std::endl;
+	}
+}
+
+int main(int argc, const char* argv[])
+{
+	Benchmark::Options options;
+	std::string jsonPath;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = i + 1 < argc;
+		if (!strcmp(argv[i], "--trials") && hasValue)
+		{
+			options.trials = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--warmup") && hasValue)
+		{
+			options.warmupRuns = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "--filter") && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--json") && hasValue)
+		{
+			jsonPath = argv[++i];
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	//With the JSON going to standard output the table goes to standard error, so the JSON can be piped straight into a file
+	std::ostream& output = jsonPath == "-" ? std::cerr : std::cout;
+
+	Benchmark::BenchmarkEngine engine;
+	const std::vector<Benchmark::Result> results = engine.RunAll(output, options);
+
+	if (jsonPath == "-")
+	{
+		Benchmark::BenchmarkEngine::WriteJson(std::cout, options, results);
+	}
+	else if (!jsonPath.empty())
+	{
+		std::ofstream jsonFile(jsonPath);
+		if (!jsonFile.is_open())
+		{
+			std::cerr << "Couldn't open " << jsonPath << " to write the results to" << std::endl;
+			return 1;
+		}
+		Benchmark::BenchmarkEngine::WriteJson(jsonFile, options, results);
+	}
+
+	return 0;
+}
@@ -1,4 +1,5 @@
 #include "Game.h"
+#include "../GameBoard/GameBoardRules.h"
 
 namespace
 {
@@ -22,13 +23,168 @@ namespace
 			return aliveNeighbors == 3;
 		}
 	}
+
+	void GameOfLifeSim(bool alive, unsigned char aliveRelatives, bool& aliveNextGen)
+	{
+		aliveNextGen = GameOfLifeCellRules(alive, aliveRelatives);
+	}
+
+	/// <summary>
+	/// Reads the neighbor counts out of one half of a rulestring, like the "36" in "B36"
+	/// </summary>
+	/// <returns>false if anything other than the digits 0 to 8 turned up</returns>
+	bool ParseNeighborCounts(std::string_view digits, unsigned short& mask)
+	{
+		mask = 0;
+		for (char digit : digits)
+		{
+			if (digit < '0' || digit > '8')
+			{
+				return false;
+			}
+			mask |= 1 << (digit - '0');
+		}
+		return true;
+	}
 }
 
-void Game::RunGameOfLifeGeneration(GameBoard::IGameBoard& gameBoard)
+const GameBoard::RuleMasks& Game::GameOfLifeRule()
 {
-	gameBoard.IterateCurrentGenerationBoard([](bool alive, unsigned char aliveRelatives, bool& aliveNextGen)
+	static const GameBoard::RuleMasks rule = GameBoard::BuildRuleMasks(&GameOfLifeSim);
+	return rule;
+}
+
+bool Game::ParseRule(std::string_view ruleString, GameBoard::RuleMasks& rule)
+{
+	const size_t slash = ruleString.find('/');
+	if (slash == std::string_view::npos)
+	{
+		return false;
+	}
+
+	std::string_view halves[2] = { ruleString.substr(0, slash), ruleString.substr(slash + 1) };
+
+	GameBoard::RuleMasks parsedRule;
+	bool foundBirth = false;
+	bool foundSurvive = false;
+	for (int half = 0; half < 2; ++half)
+	{
+		std::string_view part = halves[half];
+		const char letter = part.empty() ? '\0' : part[0];
+
+		//No letters means the old survive/birth ordering
+		bool isBirth = half == 1;
+		if (letter == 'B' || letter == 'b')
+		{
+			isBirth = true;
+			part.remove_prefix(1);
+		}
+		else if (letter == 'S' || letter == 's')
+		{
+			isBirth = false;
+			part.remove_prefix(1);
+		}
+
+		bool& found = isBirth ? foundBirth : foundSurvive;
+		if (found || !ParseNeighborCounts(part, isBirth ? parsedRule.birth : parsedRule.survive))
 		{
-			aliveNextGen = GameOfLifeCellRules(alive, aliveRelatives);
-		});
+			return false;
+		}
+		found = true;
+	}
+
+	//Birth on 0 would fill the infinite board, which none of the boards can store
+	if (parsedRule.birth & 1)
+	{
+		return false;
+	}
+
+	rule = parsedRule;
+	return true;
+}
+
+void Game::RunGeneration(GameBoard::IGameBoard& gameBoard, const GameBoard::RuleMasks& rule)
+{
+	{
+		GameBoard::Instrumentation::ScopedPhase stepTimer(GameBoard::Instrumentation::Phase::Step);
+		gameBoard.IterateCurrentGenerationBoard(rule);
+	}
 	gameBoard.FinishCurrentGeneration();
+	GameBoard::Instrumentation::EndGeneration(gameBoard, 1);
+}
+
+void Game::RunGenerations(GameBoard::IGameBoard& gameBoard, const GameBoard::RuleMasks& rule, GameBoard::UnsignedUnit generations)
+{
+	gameBoard.IterateGenerations(rule, generations);
+}
+
+Game::CycleDetector::CycleDetector() : m_history{}, m_count(0)
+{
+
+}
+
+GameBoard::UnsignedUnit Game::CycleDetector::Push(GameBoard::UnsignedUnit hash)
+{
+	m_history[m_count % m_history.size()] = hash;
+	++m_count;
+
+	//Hashes going back from the newest, so ago(0) is the one we were just given
+	auto ago = [this](GameBoard::UnsignedUnit generations)
+	{
+		return m_history[(m_count - 1 - generations) % m_history.size()];
+	};
+
+	for (GameBoard::UnsignedUnit period = 1; period <= maxPeriod && period * 2 <= m_count; ++period)
+	{
+		GameBoard::UnsignedUnit matched = 0;
+		while (matched < period && ago(matched) == ago(matched + period))
+		{
+			++matched;
+		}
+
+		if (matched == period)
+		{
+			return period;
+		}
+	}
+	return 0;
+}
+
+Game::CycleRunResult Game::RunGenerationsDetectingCycles(GameBoard::IGameBoard& gameBoard, const GameBoard::RuleMasks& rule, GameBoard::UnsignedUnit generations)
+{
+	CycleRunResult result;
+	CycleDetector detector;
+	detector.Push(gameBoard.GetBoardHash());
+
+	while (result.generationsStepped < generations)
+	{
+		RunGeneration(gameBoard, rule);
+		++result.generationsStepped;
+
+		result.period = detector.Push(gameBoard.GetBoardHash());
+		if (result.period != 0)
+		{
+			//Every period from here looks the same, so skip all the whole ones left and just run what's left over
+			const GameBoard::UnsignedUnit leftOver = (generations - result.generationsStepped) % result.period;
+			RunGenerations(gameBoard, rule, leftOver);
+			result.generationsStepped += leftOver;
+			break;
+		}
+	}
+	return result;
+}
+
+void Game::RunGameOfLifeGeneration(GameBoard::IGameBoard& gameBoard)
+{
+	RunGeneration(gameBoard, GameOfLifeRule());
+}
+
+void Game::RunGameOfLifeGenerations(GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generations)
+{
+	RunGenerations(gameBoard, GameOfLifeRule(), generations);
+}
+
+Game::CycleRunResult Game::RunGameOfLifeGenerationsDetectingCycles(GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generations)
+{
+	return RunGenerationsDetectingCycles(gameBoard, GameOfLifeRule(), generations);
 }
@@ -1,7 +1,76 @@
 #pragma once
 #include "../GameBoard/GameBoardInterface.h"
+#include <array>
+#include <string_view>
 
 namespace Game
 {
+	/// <summary>
+	/// The rule the game of life is normally played with, B3/S23
+	/// </summary>
+	const GameBoard::RuleMasks& GameOfLifeRule();
+
+	/// <summary>
+	/// Reads a Life-like rulestring into masks the boards can run. Takes the usual B/S notation in either order and either case,
+	/// like "B36/S23" or "s23/b3", and the older survive/birth form with no letters like "23/3".
+	/// Rules that give birth on 0 neighbors are turned away since they'd fill all of empty space, which none of our sparse boards can hold.
+	/// </summary>
+	/// <param name="ruleString">The rule to read</param>
+	/// <param name="rule">Where the rule goes, only touched if it was read successfully</param>
+	/// <returns>If the rulestring made sense</returns>
+	bool ParseRule(std::string_view ruleString, GameBoard::RuleMasks& rule);
+
+	void RunGeneration(GameBoard::IGameBoard& gameBoard, const GameBoard::RuleMasks& rule);
+
+	/// <summary>
+	/// Runs a number of generations and finishes them. Boards that can jump ahead, like the hashlife board, will do so.
+	/// </summary>
+	void RunGenerations(GameBoard::IGameBoard& gameBoard, const GameBoard::RuleMasks& rule, GameBoard::UnsignedUnit generations);
+
+	/// <summary>
+	/// Remembers the board hash of the last few generations and notices when they start repeating. A period only counts once a whole
+	/// period has matched the one before it, so it takes two trips around before we believe it, and a stray hash collision can't fool us.
+	/// </summary>
+	class CycleDetector
+	{
+	public:
+		//Longest period we look for. Most things that settle end up as still lifes, blinkers and the like, and the history is twice this.
+		static constexpr GameBoard::UnsignedUnit maxPeriod = 64;
+
+		CycleDetector();
+
+		/// <summary>
+		/// Adds the next generation's hash
+		/// </summary>
+		/// <returns>The period the board is repeating with, 1 if it's still, or 0 if it isn't repeating yet</returns>
+		GameBoard::UnsignedUnit Push(GameBoard::UnsignedUnit hash);
+
+	private:
+		std::array<GameBoard::UnsignedUnit, maxPeriod * 2> m_history;
+		GameBoard::UnsignedUnit m_count;
+	};
+
+	struct CycleRunResult
+	{
+		//How many generations actually got run, which is less than were asked for if the board settled down
+		GameBoard::UnsignedUnit generationsStepped = 0;
+		//The period the board settled into, or 0 if it never did
+		GameBoard::UnsignedUnit period = 0;
+	};
+
+	/// <summary>
+	/// Ends up in the same place as RunGenerations, but hashes the board every generation and stops early once it's repeating, running
+	/// only the generations needed to land on the same phase of the cycle the full count would have. Boards with anything flying off,
+	/// like a glider, never repeat exactly, so those just run the whole way.
+	/// </summary>
+	CycleRunResult RunGenerationsDetectingCycles(GameBoard::IGameBoard& gameBoard, const GameBoard::RuleMasks& rule, GameBoard::UnsignedUnit generations);
+
 	void RunGameOfLifeGeneration(GameBoard::IGameBoard& gameBoard);
-}
\ No newline at end of file
+
+	/// <summary>
+	/// Runs a number of generations and finishes them. Boards that can jump ahead, like the hashlife board, will do so.
+	/// </summary>
+	void RunGameOfLifeGenerations(GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generations);
+
+	CycleRunResult RunGameOfLifeGenerationsDetectingCycles(GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generations);
+}
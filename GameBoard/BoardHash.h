@@ -0,0 +1,120 @@
+#pragma once
+#include "GameBoardCoord.h"
+#include <array>
+#include <cstdint>
+
+//The board hash is the sum over every live cell of boardHashXBase^x * boardHashYBase^y, wrapping at 2^64. Being a sum is the whole
+//point: the hash of a board is the sum of the hashes of any pieces it's cut into, so boards made of tiles can keep one per tile and only
+//redo the tiles that changed, and moving a piece over just multiplies its hash by the bases raised to how far it moved. That makes the
+//hash the same for the same cells no matter which board they're on or how it's tiled.
+//Both bases are odd so every power is too, and since their powers repeat every 2^62 at most, exponents can wrap at 2^64 like
+//coordinates do and everything still lines up, which is how negative coordinates work.
+
+namespace GameBoard
+{
+	constexpr uint64_t boardHashXBase = 0x9E3779B97F4A7C15ull;
+	constexpr uint64_t boardHashYBase = 0xD6E8FEB86659FD93ull;
+
+	constexpr uint64_t HashPower(uint64_t base, UnsignedUnit exponent)
+	{
+		uint64_t result = 1;
+		while (exponent != 0)
+		{
+			if (exponent & 1)
+			{
+				result *= base;
+			}
+			base *= base;
+			exponent >>= 1;
+		}
+		return result;
+	}
+
+	//Entry [k][b] is the hash of the cells set in byte b if that byte was byte k of a row word, so a word takes 8 lookups rather than a
+	//multiply per cell
+	inline constexpr auto rowWordHashTables = []
+		{
+			std::array<std::array<uint64_t, 256>, 8> tables{};
+			for (int byte = 0; byte < 8; ++byte)
+			{
+				for (int bits = 0; bits < 256; ++bits)
+				{
+					uint64_t hash = 0;
+					for (int bit = 0; bit < 8; ++bit)
+					{
+						if (bits & (1 << bit))
+						{
+							hash += HashPower(boardHashXBase, byte * 8 + bit);
+						}
+					}
+					tables[byte][bits] = hash;
+				}
+			}
+			return tables;
+		}();
+
+	/// <summary>
+	/// The hash of a word of cells in a row, bit i being the cell i columns right of where the word starts, as if it started at 0
+	/// </summary>
+	inline uint64_t HashRowWord(uint64_t word)
+	{
+		uint64_t hash = 0;
+		for (int byte = 0; word != 0; ++byte, word >>= 8)
+		{
+			hash += rowWordHashTables[byte][word & 0xFF];
+		}
+		return hash;
+	}
+
+	/// <summary>
+	/// Moves a hash as though every cell in it had moved by offset
+	/// </summary>
+	inline UnsignedUnit TranslateBoardHash(UnsignedUnit hash, const Coord& offset)
+	{
+		return hash * HashPower(boardHashXBase, static_cast<UnsignedUnit>(offset.x)) * HashPower(boardHashYBase, static_cast<UnsignedUnit>(offset.y));
+	}
+
+	/// <summary>
+	/// Adds up the board hash one cell at a time. Cells usually turn up a row at a time, so the row's power is kept between cells, and a
+	/// cell right next to the last one only costs a multiply.
+	/// </summary>
+	class BoardHasher
+	{
+	public:
+		BoardHasher() : m_hash(0), m_lastCell{ 0, 0 }, m_xPower(1), m_yPower(1)
+		{
+
+		}
+
+		void Add(const Coord& cell)
+		{
+			if (cell.y != m_lastCell.y)
+			{
+				m_yPower = HashPower(boardHashYBase, static_cast<UnsignedUnit>(cell.y));
+			}
+
+			if (static_cast<UnsignedUnit>(cell.x) == static_cast<UnsignedUnit>(m_lastCell.x) + 1)
+			{
+				m_xPower *= boardHashXBase;
+			}
+			else if (cell.x != m_lastCell.x)
+			{
+				m_xPower = HashPower(boardHashXBase, static_cast<UnsignedUnit>(cell.x));
+			}
+
+			m_lastCell = cell;
+			m_hash += m_xPower * m_yPower;
+		}
+
+		UnsignedUnit Hash() const
+		{
+			return m_hash;
+		}
+
+	private:
+		UnsignedUnit m_hash;
+		Coord m_lastCell;
+		uint64_t m_xPower;
+		uint64_t m_yPower;
+	};
+}
@@ -12,6 +12,20 @@ namespace GameBoard
 		Unit y;
 	};
 
+	/// <summary>
+	/// Scrambles the bits of a 64 bit value so that values that are close together end up far apart. This is the finalizer from splitmix64,
+	/// which is cheap and good enough that hash tables can just use the low bits of the result.
+	/// </summary>
+	inline UnsignedUnit MixBits(UnsignedUnit value)
+	{
+		value ^= value >> 30;
+		value *= 0xbf58476d1ce4e5b9ull;
+		value ^= value >> 27;
+		value *= 0x94d049bb133111ebull;
+		value ^= value >> 31;
+		return value;
+	}
+
 	bool Get1DIndexFromCoord(const Coord& coord, Unit columnSize, Unit padding, Unit& output);
 	Coord GetCoordFrom1DIndex(Unit index, Unit columnSize, Unit padding);
 
@@ -38,17 +52,15 @@ namespace GameBoard
 	public:
 		size_t operator()(const Coord& coord) const
 		{
-			std::hash<Unit> unitHash;
-			size_t x = unitHash(coord.x);
-			size_t y = unitHash(coord.y);
-			return x ^ y + 0x9e3779b9 + (x << 6) + (x >> 2);
+			//Scramble y before folding in x, otherwise (x, y) and (y, x) would collide, and so would everything along a diagonal
+			return static_cast<size_t>(MixBits(static_cast<UnsignedUnit>(coord.x) ^ MixBits(static_cast<UnsignedUnit>(coord.y))));
 		}
 	};
 
 	class EqualCoord
 	{
 	public:
-		size_t operator()(const Coord& lhs, const Coord& rhs) const
+		bool operator()(const Coord& lhs, const Coord& rhs) const
 		{
 			return lhs.x == rhs.x && rhs.y == lhs.y;
 		}
@@ -1,9 +1,188 @@
 #pragma once
+#include "BoardHash.h"
 #include "GameBoardCoord.h"
+#include "Instrumentation.h"
+#include "MemoryTracking.h"
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <span>
+#include <vector>
 
 namespace GameBoard
 {
+	/// <summary>
+	/// Counts how often a board that recycles its sub boards could hand one back out (hits) versus having to make a new one (misses)
+	/// </summary>
+	struct PoolStats
+	{
+		UnsignedUnit hits = 0;
+		UnsignedUnit misses = 0;
+	};
+
+	/// <summary>
+	/// A game of life rule boiled down to which neighbor counts give birth to a dead cell and which let a live cell survive,
+	/// one bit per count. Conway's rule is B3/S23, so a birth mask of 1 << 3 and a survive mask of (1 << 2) | (1 << 3).
+	/// Boards that compute whole words of cells at a time can't call a function per cell, so this is what they get handed.
+	/// </summary>
+	struct RuleMasks
+	{
+		unsigned short birth = 0;
+		unsigned short survive = 0;
+
+		bool operator==(const RuleMasks& other) const
+		{
+			return birth == other.birth && survive == other.survive;
+		}
+
+		bool operator!=(const RuleMasks& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	/// <summary>
+	/// Reads up to 64 cells out of a row of cells packed one bit per cell, starting at any cell. Rows like this are what
+	/// GetCellRow and SetCellRow trade in, and the pieces a board wants rarely start on a word boundary.
+	/// </summary>
+	/// <param name="bits">The packed row, cell 0 is the lowest bit of the first word</param>
+	/// <param name="firstCell">The first cell to read</param>
+	/// <param name="count">How many cells to read, between 1 and 64</param>
+	/// <returns>The cells in the low count bits</returns>
+	inline uint64_t ReadRowBits(const uint64_t* bits, UnsignedUnit firstCell, int count)
+	{
+		const UnsignedUnit word = firstCell / 64;
+		const int shift = static_cast<int>(firstCell % 64);
+
+		uint64_t value = bits[word] >> shift;
+		if (shift != 0 && shift + count > 64)
+		{
+			value |= bits[word + 1] << (64 - shift);
+		}
+		return count == 64 ? value : value & ((1ull << count) - 1);
+	}
+
+	/// <summary>
+	/// The other half of ReadRowBits, writes up to 64 cells into a packed row without touching the cells around them
+	/// </summary>
+	/// <param name="bits">The packed row, cell 0 is the lowest bit of the first word</param>
+	/// <param name="firstCell">The first cell to write</param>
+	/// <param name="count">How many cells to write, between 1 and 64</param>
+	/// <param name="value">The cells to write, in the low count bits</param>
+	inline void WriteRowBits(uint64_t* bits, UnsignedUnit firstCell, int count, uint64_t value)
+	{
+		const UnsignedUnit word = firstCell / 64;
+		const int shift = static_cast<int>(firstCell % 64);
+		const uint64_t mask = count == 64 ? ~0ull : ((1ull << count) - 1);
+		value &= mask;
+
+		bits[word] = (bits[word] & ~(mask << shift)) | (value << shift);
+		if (shift != 0 && shift + count > 64)
+		{
+			bits[word + 1] = (bits[word + 1] & ~(mask >> (64 - shift))) | (value >> (64 - shift));
+		}
+	}
+
+	/// <summary>
+	/// How many words one side of a board takes when its cells are packed a bit each, which is how edges and padding get traded between
+	/// neighboring boards
+	/// </summary>
+	constexpr size_t EdgeWords(Unit length)
+	{
+		return static_cast<size_t>((length + 63) / 64);
+	}
+
+	/// <summary>
+	/// Grows a bounding box a cell or a rectangle at a time. min is inclusive and max exclusive, same as the rectangles output takes.
+	/// </summary>
+	class BoundsBuilder
+	{
+	public:
+		BoundsBuilder() : m_min{ std::numeric_limits<Unit>::max(), std::numeric_limits<Unit>::max() },
+			m_max{ std::numeric_limits<Unit>::min(), std::numeric_limits<Unit>::min() }
+		{
+
+		}
+
+		void Add(const Coord& cell)
+		{
+			Add(cell, Coord{ cell.x + 1, cell.y + 1 });
+		}
+
+		void Add(const Coord& min, const Coord& max)
+		{
+			m_min.x = std::min(m_min.x, min.x);
+			m_min.y = std::min(m_min.y, min.y);
+			m_max.x = std::max(m_max.x, max.x);
+			m_max.y = std::max(m_max.y, max.y);
+		}
+
+		/// <returns>false if nothing was added</returns>
+		bool Get(Coord& min, Coord& max) const
+		{
+			if (m_min.x > m_max.x)
+			{
+				return false;
+			}
+
+			min = m_min;
+			max = m_max;
+			return true;
+		}
+
+	private:
+		Coord m_min;
+		Coord m_max;
+	};
+
+	/// <summary>
+	/// Collects live cells into a block and hands the block on once it fills up. Boards push their cells straight into this without
+	/// going through a std::function, so the only type erased call left is the one per block, and whoever is on the other end gets to
+	/// loop over a whole block of cells at a time.
+	/// </summary>
+	class AliveCellBlock
+	{
+	public:
+		using BlockFn = std::function<void(std::span<const Coord>)>;
+
+		//Big enough that the call per block gets lost in the noise, small enough to stay in cache
+		static constexpr size_t blockSize = 4096;
+
+		explicit AliveCellBlock(BlockFn fn) : m_fn(std::move(fn))
+		{
+			m_cells.reserve(blockSize);
+		}
+
+		AliveCellBlock(const AliveCellBlock&) = delete;
+		AliveCellBlock& operator=(const AliveCellBlock&) = delete;
+
+		void Push(const Coord& cell)
+		{
+			m_cells.push_back(cell);
+			if (m_cells.size() == blockSize)
+			{
+				Flush();
+			}
+		}
+
+		/// <summary>
+		/// Hands on whatever is in the block even if it isn't full. Whoever made the block needs to call this once the board is done.
+		/// </summary>
+		void Flush()
+		{
+			if (!m_cells.empty())
+			{
+				m_fn(m_cells);
+				m_cells.clear();
+			}
+		}
+
+	private:
+		BlockFn m_fn;
+		std::vector<Coord> m_cells;
+	};
+
 	/// <summary>
 	/// This is meant to be a abstract class used as an interface which allows multiple representations of a game board.
 	/// It should represent the functinality external users will need to interact with the game board.
@@ -13,12 +192,42 @@ namespace GameBoard
 	public:
 		using GameSimFn = void (*)(bool alive, unsigned char aliveRelatives, bool& aliveNextGeneration);
 		using BoardIteratorFn = std::function<void(const Coord&)>;
+		using TileIteratorFn = std::function<void(const Coord& origin, Unit size, const IGameBoard& tile)>;
 
 		/// <summary>
 		/// Enables derived classes to be cleaned up properly
 		/// </summary>
 		virtual ~IGameBoard() {}
 
+		/// <summary>
+		/// Every board gets made through these, so every board's memory is counted without each one having to remember to. The grid
+		/// boards keep their cells inside the object, so this covers the cells of every tile too. Deleting through an IGameBoard pointer
+		/// hands back the size of the real board since the destructor is virtual.
+		/// </summary>
+		static void* operator new(size_t size)
+		{
+			Memory::RecordAllocation(Memory::Subsystem::Boards, size);
+			return ::operator new(size);
+		}
+
+		static void* operator new(size_t size, std::align_val_t alignment)
+		{
+			Memory::RecordAllocation(Memory::Subsystem::Boards, size);
+			return ::operator new(size, alignment);
+		}
+
+		static void operator delete(void* board, size_t size)
+		{
+			Memory::RecordFree(Memory::Subsystem::Boards, size);
+			::operator delete(board);
+		}
+
+		static void operator delete(void* board, size_t size, std::align_val_t alignment)
+		{
+			Memory::RecordFree(Memory::Subsystem::Boards, size);
+			::operator delete(board, alignment);
+		}
+
 		/// <summary>
 		/// Makes sure the game board is clear and ready to create a new game
 		/// </summary>
@@ -53,6 +262,128 @@ namespace GameBoard
 		/// <param name="value">the value to set the position to</param>
 		virtual void SetCell(const Coord& position, bool value) = 0;
 
+		/// <summary>
+		/// Sets a whole batch of cells to the same value. Loaders and tests that set lots of cells at once should come through here, since
+		/// boards can sort out where each cell goes for the whole batch at once instead of paying for a virtual call and a lookup per cell.
+		/// The cells don't have to be in any order.
+		/// </summary>
+		/// <param name="cells">The positions of the cells to set</param>
+		/// <param name="value">the value to set every cell to</param>
+		virtual void SetCells(std::span<const Coord> cells, bool value)
+		{
+			for (const Coord& cell : cells)
+			{
+				SetCell(cell, value);
+			}
+		}
+
+		/// <summary>
+		/// Sets a run of cells along a row, starting at start and heading right. Pattern formats like RLE describe everything as runs like
+		/// this, and boards that pack their cells into words can fill a whole run with a couple of bitwise operations instead of a call
+		/// per cell. Boards that can't do any better just set them one at a time.
+		/// </summary>
+		/// <param name="start">The leftmost cell in the run</param>
+		/// <param name="length">How many cells are in the run</param>
+		/// <param name="value">the value to set every cell in the run to</param>
+		virtual void SetCellRun(const Coord& start, Unit length, bool value)
+		{
+			for (Unit offset = 0; offset < length; ++offset)
+			{
+				SetCell(Coord{ start.x + offset, start.y }, value);
+			}
+		}
+
+		/// <summary>
+		/// Reads a row of cells in the last finished generation (same as GetCell) into bits packed 64 to a word. Boards that store their
+		/// cells as bits can hand over a word at a time, everyone else asks cell by cell.
+		/// </summary>
+		/// <param name="start">The leftmost cell in the row</param>
+		/// <param name="length">How many cells to read</param>
+		/// <param name="bits">Room for (length + 63) / 64 words, cell 0 ends up in the lowest bit of the first word</param>
+		virtual void GetCellRow(const Coord& start, Unit length, uint64_t* bits) const
+		{
+			std::fill(bits, bits + (length + 63) / 64, 0ull);
+			for (Unit offset = 0; offset < length; ++offset)
+			{
+				if (GetCell(Coord{ start.x + offset, start.y }))
+				{
+					bits[offset / 64] |= 1ull << (offset % 64);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Sets a row of cells for the current generation from bits packed 64 to a word, dead cells included. This is how snapshots come
+		/// back, a whole tile's worth of words at a time rather than a call per cell. By default the row gets broken into runs of
+		/// cells with the same value.
+		/// </summary>
+		/// <param name="start">The leftmost cell in the row</param>
+		/// <param name="length">How many cells to set</param>
+		/// <param name="bits">(length + 63) / 64 words, cell 0 is the lowest bit of the first word</param>
+		virtual void SetCellRow(const Coord& start, Unit length, const uint64_t* bits)
+		{
+			Unit runStart = 0;
+			while (runStart < length)
+			{
+				const bool value = (bits[runStart / 64] >> (runStart % 64)) & 1;
+				Unit runEnd = runStart + 1;
+				while (runEnd < length && (((bits[runEnd / 64] >> (runEnd % 64)) & 1) != 0) == value)
+				{
+					++runEnd;
+				}
+
+				SetCellRun(Coord{ start.x + runStart, start.y }, runEnd - runStart, value);
+				runStart = runEnd;
+			}
+		}
+
+		/// <summary>
+		/// Packs the outermost cells of the generation being written so a neighboring board can use them as its padding. By default
+		/// this is a GetCurrentCell per cell, boards that keep their cells in words can do a lot better.
+		/// </summary>
+		/// <param name="length">The board covers [0, length) in both directions</param>
+		/// <param name="edges">4 * EdgeWords(length) words: the top row, the bottom row, the left column and the right column,
+		/// each starting from the lowest bit at the smallest coordinate</param>
+		virtual void GetCurrentEdgeCells(Unit length, uint64_t* edges) const
+		{
+			const size_t words = EdgeWords(length);
+			std::fill(edges, edges + 4 * words, 0ull);
+			for (Unit i = 0; i < length; ++i)
+			{
+				const uint64_t bit = 1ull << (i % 64);
+				const size_t word = static_cast<size_t>(i / 64);
+				edges[word] |= GetCurrentCell(Coord{ i, 0 }) ? bit : 0;
+				edges[words + word] |= GetCurrentCell(Coord{ i, length - 1 }) ? bit : 0;
+				edges[2 * words + word] |= GetCurrentCell(Coord{ 0, i }) ? bit : 0;
+				edges[3 * words + word] |= GetCurrentCell(Coord{ length - 1, i }) ? bit : 0;
+			}
+		}
+
+		/// <summary>
+		/// Sets the whole ring of padding cells around the board for the generation being written, dead cells included. The other half
+		/// of GetCurrentEdgeCells, the sides come in the same order and layout with the corners tacked on the end.
+		/// </summary>
+		/// <param name="length">The board covers [0, length) in both directions, so the padding is at -1 and length</param>
+		/// <param name="padding">4 * EdgeWords(length) + 1 words: the row above, the row below, the column to the left and the column to
+		/// the right, then the top left, top right, bottom left and bottom right corners in the low 4 bits of the last word</param>
+		virtual void SetPaddingCells(Unit length, const uint64_t* padding)
+		{
+			const size_t words = EdgeWords(length);
+			SetCellRow(Coord{ 0, -1 }, length, padding);
+			SetCellRow(Coord{ 0, length }, length, padding + words);
+			for (Unit i = 0; i < length; ++i)
+			{
+				SetCell(Coord{ -1, i }, ((padding[2 * words + i / 64] >> (i % 64)) & 1) != 0);
+				SetCell(Coord{ length, i }, ((padding[3 * words + i / 64] >> (i % 64)) & 1) != 0);
+			}
+
+			const uint64_t corners = padding[4 * words];
+			SetCell(Coord{ -1, -1 }, (corners & 1) != 0);
+			SetCell(Coord{ length, -1 }, (corners & 2) != 0);
+			SetCell(Coord{ -1, length }, (corners & 4) != 0);
+			SetCell(Coord{ length, length }, (corners & 8) != 0);
+		}
+
 		/// <summary>
 		/// Gets the size in cells a given game board can support. All boards have limits, even our "infinite" ones.
 		/// </summary>
@@ -65,12 +396,111 @@ namespace GameBoard
 		/// </summary>
 		virtual void FinishCurrentGeneration() = 0;
 
+		/// <summary>
+		/// Tells us if the generation being written is any different from the last finished one, inside the padding. A board that has
+		/// stopped changing and whose padding isn't changing either will keep coming out the same, so there's no need to step it.
+		/// Boards that can't tell cheaply just say yes, which only means nobody will skip them.
+		/// </summary>
+		/// <returns>If anything changed since the last generation</returns>
+		virtual bool CurrentGenerationChanged() const
+		{
+			return true;
+		}
+
 		/// <summary>
 		/// So this is the meat of the game of life sim as far as the board is concerned. This allows access to however the board decides
 		/// to store the game of life board in a way that lets us run the game of life with our rules. 
 		/// </summary>
-		/// <param name="gameSim">The function that will run the game of life</param>
-		virtual void IterateCurrentGenerationBoard(GameSimFn gameSim) = 0;
+		/// <param name="rule">The rule to run the game of life with</param>
+		virtual void IterateCurrentGenerationBoard(const RuleMasks& rule) = 0;
+
+		/// <summary>
+		/// Runs a number of whole generations in one go, finishing each of them. Most boards can only get there one generation at a time,
+		/// but boards that can skip ahead (like the hashlife board) override this.
+		/// </summary>
+		/// <param name="rule">The rule to run the game of life with</param>
+		/// <param name="generations">How many generations to run</param>
+		virtual void IterateGenerations(const RuleMasks& rule, UnsignedUnit generations)
+		{
+			for (UnsignedUnit generation = 0; generation < generations; ++generation)
+			{
+				{
+					Instrumentation::ScopedPhase stepTimer(Instrumentation::Phase::Step);
+					IterateCurrentGenerationBoard(rule);
+				}
+				FinishCurrentGeneration();
+				Instrumentation::EndGeneration(*this, 1);
+			}
+		}
+
+		/// <summary>
+		/// A hash of the finished generation (what GetCell reads), for noticing when the board comes back around to a generation it has
+		/// already been through. It's the sum of every live cell's hash (see BoardHash.h), so the same cells hash the same on every board,
+		/// and boards made of tiles can keep a hash per tile and only redo the ones that changed. By default every live cell gets walked.
+		/// </summary>
+		virtual UnsignedUnit GetBoardHash() const
+		{
+			BoardHasher hasher;
+			AliveCellBlock block([&hasher](std::span<const Coord> cells)
+				{
+					for (const Coord& cell : cells)
+					{
+						hasher.Add(cell);
+					}
+				});
+			CollectCurrentGenerationAliveCells(Coord{ 0, 0 }, block);
+			block.Flush();
+			return hasher.Hash();
+		}
+
+		/// <summary>
+		/// How many cells are alive in the finished generation. Every board keeps this as it goes so it's cheap enough to ask every
+		/// generation, the walk here is only for boards that don't.
+		/// </summary>
+		virtual UnsignedUnit GetPopulation() const
+		{
+			UnsignedUnit population = 0;
+			AliveCellBlock block([&population](std::span<const Coord> cells) { population += cells.size(); });
+			CollectCurrentGenerationAliveCells(Coord{ 0, 0 }, block);
+			block.Flush();
+			return population;
+		}
+
+		/// <summary>
+		/// The smallest rectangle holding every live cell in the finished generation. Kept as the board goes, like the population, and it
+		/// comes out the same way PrintGameRectToFile takes it so it can be handed straight over.
+		/// </summary>
+		/// <param name="min">The top left live cell corner, inclusive</param>
+		/// <param name="max">One past the bottom right, exclusive</param>
+		/// <returns>false if there aren't any live cells, in which case min and max aren't touched</returns>
+		virtual bool GetBoundingBox(Coord& min, Coord& max) const
+		{
+			BoundsBuilder bounds;
+			AliveCellBlock block([&bounds](std::span<const Coord> cells)
+				{
+					for (const Coord& cell : cells)
+					{
+						bounds.Add(cell);
+					}
+				});
+			CollectCurrentGenerationAliveCells(Coord{ 0, 0 }, block);
+			block.Flush();
+			return bounds.Get(min, max);
+		}
+
+		/// <summary>
+		/// Boards that pool their sub boards can report how that's going. Everyone else doesn't pool anything so there's nothing to report.
+		/// </summary>
+		virtual PoolStats GetPoolStats() const
+		{
+			return PoolStats{};
+		}
+
+		/// <summary>
+		/// Roughly how much memory the board is holding on to, itself included, for keeping an eye on growth rather than exact accounting.
+		/// Containers are counted by what they hold plus a guess at their per entry overhead.
+		/// </summary>
+		virtual UnsignedUnit GetBytesResident() const = 0;
 
 		/// <summary>
 		/// I was really trying to figure out how to capture the contents of the grid, without directly exposing the
@@ -85,8 +515,71 @@ namespace GameBoard
 		/// <param name="parentCoord">Allows recursive grids to offset from local coordinates</param>
 		/// <param name="fn">The function to run only on alive cells in the grid.</param>
 		virtual void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const = 0;
+
+		/// <summary>
+		/// The fast way to get at the live cells. Instead of calling a std::function per cell (which for the multi grid also goes
+		/// through every grid's own std::function), boards push their cells into the block directly, and the block gets handed on
+		/// a few thousand cells at a time. Boards that don't do anything special just forward IterateCurrentGenerationAliveCells.
+		/// Most callers want ForEachAliveCell rather than calling this.
+		/// </summary>
+		/// <param name="parentCoord">Allows recursive grids to offset from local coordinates</param>
+		/// <param name="block">Where the live cells go. It doesn't get flushed, that's up to whoever made it.</param>
+		virtual void CollectCurrentGenerationAliveCells(const Coord& parentCoord, AliveCellBlock& block) const
+		{
+			IterateCurrentGenerationAliveCells(parentCoord, [&block](const Coord& cell) { block.Push(cell); });
+		}
+
+		/// <summary>
+		/// Hands back every live cell a row at a time (the same order as LessCoord), for output that shouldn't depend on how the board
+		/// happens to store things. By default this walks the cells and sorts them if they didn't already come out in order, boards
+		/// that can put them in order more cheaply than that can override it.
+		/// </summary>
+		/// <param name="cells">Gets filled with the live cells, anything already in it is thrown away</param>
+		virtual void GetSortedAliveCells(std::vector<Coord>& cells) const
+		{
+			cells.clear();
+
+			AliveCellBlock block([&cells](std::span<const Coord> blockCells) { cells.insert(cells.end(), blockCells.begin(), blockCells.end()); });
+			CollectCurrentGenerationAliveCells(Coord{ 0, 0 }, block);
+			block.Flush();
+
+			if (!std::is_sorted(cells.begin(), cells.end(), LessCoord()))
+			{
+				std::sort(cells.begin(), cells.end(), LessCoord());
+			}
+		}
+
+		/// <summary>
+		/// Boards made of square sub boards can hand them over one at a time, so a snapshot can copy each one out as rows of words.
+		/// Empty tiles are skipped. Everyone else isn't made of tiles and says so, and gets saved from their alive cells instead.
+		/// </summary>
+		/// <param name="fn">Gets the cell the tile's top left corner sits on, the tile's width and height, and the tile itself. Cells in
+		/// the tile are read with the tile's own coordinates, starting at 0.</param>
+		/// <returns>If this board is made of tiles. Nothing gets passed to fn if not.</returns>
+		virtual bool IterateTiles(TileIteratorFn fn) const
+		{
+			return false;
+		}
 	};
 
+	/// <summary>
+	/// Runs fn on every live cell of the board. fn is called directly from a loop over each block of cells, so it can be inlined, which
+	/// makes this the way to go for anything that touches every cell like counting, output or analysis.
+	/// </summary>
+	template<class CellFn>
+	void ForEachAliveCell(const IGameBoard& gameBoard, CellFn&& fn)
+	{
+		AliveCellBlock block([&fn](std::span<const Coord> cells)
+			{
+				for (const Coord& cell : cells)
+				{
+					fn(cell);
+				}
+			});
+		gameBoard.CollectCurrentGenerationAliveCells(Coord{ 0, 0 }, block);
+		block.Flush();
+	}
+
 	using IGameBoardPtr = std::unique_ptr<IGameBoard>;
 	using GameBoardCreationFn = IGameBoardPtr(*)();
 
@@ -112,7 +605,52 @@ namespace GameBoard
 	IGameBoardPtr CreateStaticGridBoard6();
 	IGameBoardPtr CreateStaticGridBoard();
 
-	IGameBoardPtr CreateMultiGridBoard(GameBoardCreationFn subBoardCreationFn);
+	/// <summary>
+	/// A large fixed size grid stored as 64 column strips, stepped with the widest SIMD instructions the CPU supports (AVX-512, AVX2, SSE2
+	/// or plain 64 bit words), picked at runtime. Like the static grid it has one cell of padding so it can be used as a MultiGridBoard
+	/// sub board, where it's the better choice for dense regions that run for a long time.
+	/// </summary>
+	/// <returns>A 254x254 game board</returns>
+	IGameBoardPtr CreateSimdGridBoard();
+	IGameBoardPtr CreateSimdGridBoard62();
+	IGameBoardPtr CreateSimdGridBoard1022();
+
+	/// <summary>
+	/// A sparse, unbounded board made of sub boards tiled next to each other, which get made and thrown away as cells move around.
+	/// The sub boards don't depend on each other within a generation, so they can be stepped on several threads at once.
+	/// </summary>
+	/// <param name="subBoardCreationFn">Makes the sub boards, which need one cell of padding</param>
+	/// <param name="workerCount">How many threads step the sub boards. 1 keeps everything on the calling thread, 0 uses every hardware thread.</param>
+	IGameBoardPtr CreateMultiGridBoard(GameBoardCreationFn subBoardCreationFn, unsigned workerCount = 1);
+
+	/// <summary>
+	/// A multi grid board that picks its own sub boards, anywhere from 6x6 static grids to 1022x1022 simd grids. Every so often it looks at
+	/// how spread out the live cells are and moves them onto a different tile size if that looks a lot cheaper to step, so sparse glider
+	/// fields get small tiles and dense soups get big ones.
+	/// </summary>
+	/// <param name="workerCount">How many threads step the sub boards, the same as CreateMultiGridBoard</param>
+	IGameBoardPtr CreateAdaptiveGridBoard(unsigned workerCount = 1);
+
+	/// <summary>
+	/// A hashlife board, covering the whole 64 bit space with a quadtree where every distinct pattern is stored once and remembers its own
+	/// future. It's slower than the grid boards one generation at a time, but for patterns that repeat themselves it can jump ahead
+	/// 2^k generations in a single step through IterateGenerations, which makes asking for billions of generations reasonable.
+	/// </summary>
+	/// <returns>A game board that can skip ahead through large numbers of generations</returns>
+	IGameBoardPtr CreateHashLifeBoard();
+
+	/// <summary>
+	/// The "cheater mode" from the list below. Cells can't spread faster than one a generation, so a pattern inside min to max can't get
+	/// further than generations cells outside it in that many generations, and this makes one flat bit plane that covers exactly that,
+	/// all of it allocated up front and stepped with the same kernels as the simd grid. Results are only the real infinite board's for
+	/// the first generations generations, after that anything reaching the edge of the plane dies there.
+	/// </summary>
+	/// <param name="min">Inclusive corner of the starting pattern's bounding box</param>
+	/// <param name="max">Exclusive corner of the starting pattern's bounding box</param>
+	/// <param name="generations">How many generations the board has to match the infinite board for</param>
+	/// <param name="maximumBytes">Biggest plane worth making, since a wide pattern run a long way gets big fast</param>
+	/// <returns>The board, or nullptr if it would be bigger than maximumBytes or wouldn't fit in the 64 bit space</returns>
+	IGameBoardPtr CreatePreallocatedGridBoard(const Coord& min, const Coord& max, UnsignedUnit generations, UnsignedUnit maximumBytes = 256ull * 1024 * 1024);
 
 
 	// Other board types I was thinking about...
@@ -0,0 +1,288 @@
+#pragma once
+#include "GameBoardInterface.h"
+#include <utility>
+
+namespace GameBoard
+{
+	/// <summary>
+	/// Rules written as a function only have 18 possible inputs, so it's cheap to just ask it about all of them.
+	/// </summary>
+	/// <param name="gameSim">The function that runs the game of life</param>
+	/// <returns>The masks that give the same answers as gameSim</returns>
+	inline RuleMasks BuildRuleMasks(IGameBoard::GameSimFn gameSim)
+	{
+		RuleMasks rule;
+		for (unsigned char count = 0; count <= 8; ++count)
+		{
+			bool aliveNextGen = false;
+			gameSim(false, count, aliveNextGen);
+			rule.birth |= aliveNextGen << count;
+
+			aliveNextGen = false;
+			gameSim(true, count, aliveNextGen);
+			rule.survive |= aliveNextGen << count;
+		}
+		return rule;
+	}
+
+	/// <summary>
+	/// The same thing as RuleMasks but known at compile time, so the kernels can be built for just this rule. Only the neighbor counts the
+	/// rule cares about make it into the code, and there are no branches left on the rule at all.
+	/// </summary>
+	template<unsigned short birthMask, unsigned short surviveMask>
+	struct StaticRule
+	{
+		static constexpr unsigned short birth = birthMask;
+		static constexpr unsigned short survive = surviveMask;
+	};
+
+	//B3/S23
+	using ConwayRule = StaticRule<1 << 3, (1 << 2) | (1 << 3)>;
+	//B36/S23
+	using HighLifeRule = StaticRule<(1 << 3) | (1 << 6), (1 << 2) | (1 << 3)>;
+	//B3678/S34678
+	using DayAndNightRule = StaticRule<(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8), (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8)>;
+	//B2/S
+	using SeedsRule = StaticRule<1 << 2, 0>;
+
+	template<class... Rules>
+	struct RuleList
+	{
+	};
+
+	/// <summary>
+	/// The rules that get their own compiled kernels. Anything else runs off the RuleMasks, which works for every rule but has to look
+	/// at the masks as it goes.
+	/// </summary>
+	using CompiledRules = RuleList<ConwayRule, HighLifeRule, DayAndNightRule, SeedsRule>;
+
+	template<class Fn>
+	decltype(auto) DispatchRule(const RuleMasks& rule, Fn&& fn, RuleList<>)
+	{
+		return fn(rule);
+	}
+
+	template<class Fn, class Rule, class... Rules>
+	decltype(auto) DispatchRule(const RuleMasks& rule, Fn&& fn, RuleList<Rule, Rules...>)
+	{
+		if (rule.birth == Rule::birth && rule.survive == Rule::survive)
+		{
+			return fn(Rule{});
+		}
+		return DispatchRule(rule, std::forward<Fn>(fn), RuleList<Rules...>{});
+	}
+
+	/// <summary>
+	/// Calls fn with the compiled rule matching the masks if there is one, or with the masks themselves otherwise. This is meant to be done
+	/// once per board (or once per generation), so that everything fn does for every cell is built for the rule.
+	/// </summary>
+	template<class Fn>
+	decltype(auto) DispatchRule(const RuleMasks& rule, Fn&& fn)
+	{
+		return DispatchRule(rule, std::forward<Fn>(fn), CompiledRules{});
+	}
+
+	/// <summary>
+	/// The bitwise operations the kernels below need, for anything that has the bitwise operators like std::bitset or a plain 64 bit word.
+	/// The SIMD board has versions of these for each instruction set.
+	/// </summary>
+	template<class Bits>
+	struct BitwiseOps
+	{
+		using Vector = Bits;
+		static Bits Zero() { return Bits{}; }
+		static Bits AllSet() { return ~Bits{}; }
+		static Bits And(const Bits& a, const Bits& b) { return a & b; }
+		static Bits Or(const Bits& a, const Bits& b) { return a | b; }
+		static Bits Xor(const Bits& a, const Bits& b) { return a ^ b; }
+		static Bits AndNot(const Bits& notThis, const Bits& b) { return ~notThis & b; }
+	};
+
+	/// <summary>
+	/// How many live neighbors every cell has, spread across 4 bit planes. Names are the weight of the bit each plane holds.
+	/// </summary>
+	template<class Vector>
+	struct NeighborCounts
+	{
+		Vector ones;
+		Vector twos;
+		Vector fours;
+		Vector eights;
+	};
+
+	/// <summary>
+	/// Rather than counting each cell's neighbors, the 8 neighbor planes get summed with a tree of full adders so every cell's count
+	/// ends up spread across 4 bit planes.
+	/// </summary>
+	/// <param name="neighbors">The cells shifted so that each cell lines up with one of its 8 neighbors, in any order</param>
+	template<class Ops, class Vector>
+	inline NeighborCounts<Vector> CountNeighbors(const Vector (&neighbors)[8])
+	{
+		const Vector halfA = Ops::Xor(neighbors[0], neighbors[1]);
+		const Vector sumA = Ops::Xor(halfA, neighbors[2]);
+		const Vector carryA = Ops::Or(Ops::And(neighbors[0], neighbors[1]), Ops::And(halfA, neighbors[2]));
+		const Vector halfB = Ops::Xor(neighbors[3], neighbors[4]);
+		const Vector sumB = Ops::Xor(halfB, neighbors[5]);
+		const Vector carryB = Ops::Or(Ops::And(neighbors[3], neighbors[4]), Ops::And(halfB, neighbors[5]));
+		const Vector sumC = Ops::Xor(neighbors[6], neighbors[7]);
+		const Vector carryC = Ops::And(neighbors[6], neighbors[7]);
+		const Vector halfD = Ops::Xor(sumA, sumB);
+		const Vector carryD = Ops::Or(Ops::And(sumA, sumB), Ops::And(halfD, sumC));
+
+		const Vector halfE = Ops::Xor(carryA, carryB);
+		const Vector twosPartial = Ops::Xor(halfE, carryC);
+		const Vector foursA = Ops::Or(Ops::And(carryA, carryB), Ops::And(halfE, carryC));
+		const Vector foursB = Ops::And(twosPartial, carryD);
+
+		NeighborCounts<Vector> counts;
+		counts.ones = Ops::Xor(halfD, sumC);
+		counts.twos = Ops::Xor(twosPartial, carryD);
+		counts.fours = Ops::Xor(foursA, foursB);
+		counts.eights = Ops::And(foursA, foursB);
+		return counts;
+	}
+
+	/// <summary>
+	/// The cells whose neighbor count is exactly count. 8 is the only count with the eights bit set and it has none of the others, so
+	/// the eights plane only needs checking for counts of 0 and 8.
+	/// </summary>
+	template<class Ops, class Vector>
+	inline Vector MatchCount(const NeighborCounts<Vector>& counts, unsigned int count)
+	{
+		if (count == 8)
+		{
+			return counts.eights;
+		}
+
+		Vector matches = count == 0 ? Ops::AndNot(counts.eights, Ops::AllSet()) : Ops::AllSet();
+		matches = (count & 1) ? Ops::And(matches, counts.ones) : Ops::AndNot(counts.ones, matches);
+		matches = (count & 2) ? Ops::And(matches, counts.twos) : Ops::AndNot(counts.twos, matches);
+		matches = (count & 4) ? Ops::And(matches, counts.fours) : Ops::AndNot(counts.fours, matches);
+		return matches;
+	}
+
+	/// <summary>
+	/// Same as MatchCount, but with the count known at compile time so none of the planes we don't need get touched
+	/// </summary>
+	template<class Ops, unsigned int count, class Vector>
+	inline Vector MatchCount(const NeighborCounts<Vector>& counts)
+	{
+		if constexpr (count == 8)
+		{
+			return counts.eights;
+		}
+		else
+		{
+			//Start from the lowest plane the count needs set so we never have to AND against all ones
+			Vector matches;
+			if constexpr ((count & 1) != 0)
+			{
+				matches = counts.ones;
+			}
+			else if constexpr ((count & 2) != 0)
+			{
+				matches = Ops::AndNot(counts.ones, counts.twos);
+			}
+			else if constexpr ((count & 4) != 0)
+			{
+				matches = Ops::AndNot(counts.twos, Ops::AndNot(counts.ones, counts.fours));
+			}
+			else
+			{
+				return Ops::AndNot(Ops::Or(Ops::Or(counts.ones, counts.twos), Ops::Or(counts.fours, counts.eights)), Ops::AllSet());
+			}
+
+			if constexpr ((count & 1) != 0)
+			{
+				matches = (count & 2) ? Ops::And(matches, counts.twos) : Ops::AndNot(counts.twos, matches);
+			}
+			if constexpr ((count & 3) != 0)
+			{
+				matches = (count & 4) ? Ops::And(matches, counts.fours) : Ops::AndNot(counts.fours, matches);
+			}
+			return matches;
+		}
+	}
+
+	/// <summary>
+	/// Applies a rule only known at run time, for every neighbor count that leads to a live cell
+	/// </summary>
+	template<class Ops, class Vector>
+	inline Vector ApplyRule(const Vector& current, const NeighborCounts<Vector>& counts, const RuleMasks& rule)
+	{
+		Vector next = Ops::Zero();
+		for (unsigned int count = 0; count <= 8; ++count)
+		{
+			const bool birth = (rule.birth >> count) & 1;
+			const bool survive = (rule.survive >> count) & 1;
+			if (!birth && !survive)
+			{
+				continue;
+			}
+
+			Vector matches = MatchCount<Ops>(counts, count);
+			if (!birth)
+			{
+				matches = Ops::And(matches, current);
+			}
+			else if (!survive)
+			{
+				matches = Ops::AndNot(current, matches);
+			}
+			next = Ops::Or(next, matches);
+		}
+		return next;
+	}
+
+	template<class Ops, unsigned short birth, unsigned short survive, class Vector, unsigned int... counts>
+	inline Vector ApplyStaticRule(const Vector& current, const NeighborCounts<Vector>& neighborCounts, std::integer_sequence<unsigned int, counts...>)
+	{
+		Vector next = Ops::Zero();
+		auto applyCount = [&](auto countConstant)
+		{
+			constexpr unsigned int count = decltype(countConstant)::value;
+			constexpr bool isBirth = (birth >> count) & 1;
+			constexpr bool isSurvive = (survive >> count) & 1;
+			if constexpr (isBirth || isSurvive)
+			{
+				Vector matches = MatchCount<Ops, count>(neighborCounts);
+				if constexpr (!isBirth)
+				{
+					matches = Ops::And(matches, current);
+				}
+				else if constexpr (!isSurvive)
+				{
+					matches = Ops::AndNot(current, matches);
+				}
+				next = Ops::Or(next, matches);
+			}
+		};
+		(applyCount(std::integral_constant<unsigned int, counts>{}), ...);
+		return next;
+	}
+
+	/// <summary>
+	/// Applies a rule known at compile time. This unrolls to just the counts the rule cares about, for Conway that's a count of 3, or
+	/// a count of 2 on a live cell.
+	/// </summary>
+	template<class Ops, class Vector, unsigned short birth, unsigned short survive>
+	inline Vector ApplyRule(const Vector& current, const NeighborCounts<Vector>& counts, StaticRule<birth, survive>)
+	{
+		return ApplyStaticRule<Ops, birth, survive>(current, counts, std::make_integer_sequence<unsigned int, 9>{});
+	}
+
+	/// <summary>
+	/// Runs the rule on a whole block of cells at once for boards that store one cell per bit. Works on anything with the bitwise
+	/// operators, like std::bitset or a plain 64 bit word.
+	/// </summary>
+	/// <param name="current">The cells as they are now</param>
+	/// <param name="neighbors">The cells shifted so that each cell lines up with one of its 8 neighbors, in any order</param>
+	/// <param name="rule">The rule to run, either RuleMasks or a StaticRule</param>
+	/// <returns>The cells in the next generation</returns>
+	template<class Bits, class Rule>
+	Bits NextGeneration(const Bits& current, const Bits (&neighbors)[8], const Rule& rule)
+	{
+		using Ops = BitwiseOps<Bits>;
+		return ApplyRule<Ops>(current, CountNeighbors<Ops>(neighbors), rule);
+	}
+}
@@ -0,0 +1,295 @@
+#pragma once
+#include "GameBoardRules.h"
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+//The strip kernel the SIMD grid boards step with. Boards store their cells as vertical strips 64 columns wide, one word per row, and
+//SelectStepStripFn hands back the widest version of the kernel this CPU can run.
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GAMEBOARD_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+//MSVC lets us use any intrinsic anywhere. gcc and clang need each function to say which instruction sets it is allowed to use,
+//and refuse to inline a helper into a function compiled for a different set, so instead of forcing the helpers inline each
+//kernel entry point is flattened, which pulls everything it calls into it with the entry point's instruction set.
+#if defined(_MSC_VER)
+#define GAMEBOARD_FORCE_INLINE __forceinline
+#define GAMEBOARD_TARGET(instructionSet)
+#define GAMEBOARD_FLATTEN
+#else
+#define GAMEBOARD_FORCE_INLINE inline
+#define GAMEBOARD_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#define GAMEBOARD_FLATTEN __attribute__((flatten))
+#endif
+
+namespace GameBoard
+{
+	/// <summary>
+	/// The widest instruction set the machine we're running on supports, in increasing order of width
+	/// </summary>
+	enum class SimdLevel
+	{
+		Scalar,
+		Sse2,
+		Avx2,
+		Avx512,
+	};
+
+	/// <summary>
+	/// Asks the CPU what it can do. Having the instructions isn't enough for the wide registers, the OS also has to have
+	/// agreed to save them between context switches, so that gets checked too.
+	/// </summary>
+	inline SimdLevel DetectSimdLevel()
+	{
+#if defined(GAMEBOARD_SIMD_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		const bool sse2 = (info[3] & (1 << 26)) != 0;
+		const bool osSavesVectors = (info[2] & (1 << 27)) != 0;
+		const unsigned long long enabledState = osSavesVectors ? _xgetbv(0) : 0;
+
+		bool avx2 = false;
+		bool avx512 = false;
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0 && (enabledState & 0x6) == 0x6;
+			avx512 = (info[1] & (1 << 16)) != 0 && (enabledState & 0xe6) == 0xe6;
+		}
+
+		return avx512 ? SimdLevel::Avx512 : avx2 ? SimdLevel::Avx2 : sse2 ? SimdLevel::Sse2 : SimdLevel::Scalar;
+#elif defined(GAMEBOARD_SIMD_X86)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+		{
+			return SimdLevel::Avx512;
+		}
+		if (__builtin_cpu_supports("avx2"))
+		{
+			return SimdLevel::Avx2;
+		}
+		if (__builtin_cpu_supports("sse2"))
+		{
+			return SimdLevel::Sse2;
+		}
+		return SimdLevel::Scalar;
+#else
+		return SimdLevel::Scalar;
+#endif
+	}
+
+	// Each of these wraps one register width in the same handful of operations so the kernel below only has to be written once.
+	// A lane holds one 64 bit row of a strip, so a wider register just means more rows stepped per instruction.
+
+	struct ScalarOps
+	{
+		using Vector = uint64_t;
+		static constexpr int lanes = 1;
+
+		static GAMEBOARD_FORCE_INLINE Vector Load(const uint64_t* bits) { return *bits; }
+		static GAMEBOARD_FORCE_INLINE void Store(uint64_t* bits, Vector value) { *bits = value; }
+		static GAMEBOARD_FORCE_INLINE Vector Set(uint64_t value) { return value; }
+		static GAMEBOARD_FORCE_INLINE Vector Zero() { return 0; }
+		static GAMEBOARD_FORCE_INLINE Vector AllSet() { return ~0ull; }
+		static GAMEBOARD_FORCE_INLINE Vector And(Vector a, Vector b) { return a & b; }
+		static GAMEBOARD_FORCE_INLINE Vector Or(Vector a, Vector b) { return a | b; }
+		static GAMEBOARD_FORCE_INLINE Vector Xor(Vector a, Vector b) { return a ^ b; }
+		static GAMEBOARD_FORCE_INLINE Vector AndNot(Vector notThis, Vector b) { return ~notThis & b; }
+		template<int shift> static GAMEBOARD_FORCE_INLINE Vector ShiftLeft(Vector a) { return a << shift; }
+		template<int shift> static GAMEBOARD_FORCE_INLINE Vector ShiftRight(Vector a) { return a >> shift; }
+	};
+
+#if defined(GAMEBOARD_SIMD_X86)
+	struct Sse2Ops
+	{
+		using Vector = __m128i;
+		static constexpr int lanes = 2;
+
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector Load(const uint64_t* bits) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits)); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") void Store(uint64_t* bits, Vector value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(bits), value); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector Set(uint64_t value) { return _mm_set1_epi64x(static_cast<long long>(value)); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector Zero() { return _mm_setzero_si128(); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector AllSet() { return _mm_set1_epi64x(-1); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector Xor(Vector a, Vector b) { return _mm_xor_si128(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector AndNot(Vector notThis, Vector b) { return _mm_andnot_si128(notThis, b); }
+		template<int shift> static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector ShiftLeft(Vector a) { return _mm_slli_epi64(a, shift); }
+		template<int shift> static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("sse2") Vector ShiftRight(Vector a) { return _mm_srli_epi64(a, shift); }
+	};
+
+	struct Avx2Ops
+	{
+		using Vector = __m256i;
+		static constexpr int lanes = 4;
+
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector Load(const uint64_t* bits) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits)); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") void Store(uint64_t* bits, Vector value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(bits), value); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector Set(uint64_t value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector Zero() { return _mm256_setzero_si256(); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector AllSet() { return _mm256_set1_epi64x(-1); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector Xor(Vector a, Vector b) { return _mm256_xor_si256(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector AndNot(Vector notThis, Vector b) { return _mm256_andnot_si256(notThis, b); }
+		template<int shift> static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector ShiftLeft(Vector a) { return _mm256_slli_epi64(a, shift); }
+		template<int shift> static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx2") Vector ShiftRight(Vector a) { return _mm256_srli_epi64(a, shift); }
+	};
+
+	struct Avx512Ops
+	{
+		using Vector = __m512i;
+		static constexpr int lanes = 8;
+
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector Load(const uint64_t* bits) { return _mm512_loadu_si512(bits); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") void Store(uint64_t* bits, Vector value) { _mm512_storeu_si512(bits, value); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector Set(uint64_t value) { return _mm512_set1_epi64(static_cast<long long>(value)); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector Zero() { return _mm512_setzero_si512(); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector AllSet() { return _mm512_set1_epi64(-1); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector And(Vector a, Vector b) { return _mm512_and_si512(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector Or(Vector a, Vector b) { return _mm512_or_si512(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector Xor(Vector a, Vector b) { return _mm512_xor_si512(a, b); }
+		static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector AndNot(Vector notThis, Vector b) { return _mm512_andnot_si512(notThis, b); }
+		template<int shift> static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector ShiftLeft(Vector a) { return _mm512_slli_epi64(a, shift); }
+		template<int shift> static GAMEBOARD_FORCE_INLINE GAMEBOARD_TARGET("avx512f") Vector ShiftRight(Vector a) { return _mm512_srli_epi64(a, shift); }
+	};
+#endif
+
+	//The widest register steps 8 rows at a time, and the rows it steps can't include both padding rows
+	constexpr int minimumStripRows = 10;
+
+	/// <summary>
+	/// Steps one 64 column strip of a board. Every word is one row of the strip, bit n being column n, so the cells to our west and east
+	/// are just the row shifted by a bit with the bit that falls off the edge borrowed from the neighboring strip. Vertical neighbors are
+	/// the rows above and below, which means we can step as many rows at a time as the register has lanes without shuffling anything.
+	/// </summary>
+	/// <param name="west">The strip to our west in the front buffer, all zero if there isn't one</param>
+	/// <param name="center">The strip we are stepping in the front buffer</param>
+	/// <param name="east">The strip to our east in the front buffer, all zero if there isn't one</param>
+	/// <param name="output">The strip we are stepping in the back buffer</param>
+	/// <param name="rowCount">How many rows the strip has, padding included. Has to be at least minimumStripRows.</param>
+	/// <param name="interiorColumns">Bits of each row that aren't padding. Padding columns in output are left as they are.</param>
+	/// <param name="rule">The rule to run, either RuleMasks or a StaticRule</param>
+	template<class Ops, class Rule>
+	GAMEBOARD_FORCE_INLINE void StepStrip(const uint64_t* west, const uint64_t* center, const uint64_t* east, uint64_t* output, int rowCount, uint64_t interiorColumns, const Rule& rule)
+	{
+		using Vector = typename Ops::Vector;
+
+		const Vector interior = Ops::Set(interiorColumns);
+
+		for (int row = 1; row < rowCount - 1; row += Ops::lanes)
+		{
+			//The last batch of rows may not fit, so slide it back to overlap the previous batch rather than stepping into the padding row.
+			//Recomputing a few rows is harmless since we only read the front buffer.
+			const int firstRow = std::min(row, rowCount - 1 - Ops::lanes);
+
+			const Vector current = Ops::Load(center + firstRow);
+
+			Vector neighbors[8];
+			for (int dy = -1; dy <= 1; ++dy)
+			{
+				const Vector centerRows = Ops::Load(center + firstRow + dy);
+				const Vector fromWest = Ops::Or(Ops::template ShiftLeft<1>(centerRows), Ops::template ShiftRight<63>(Ops::Load(west + firstRow + dy)));
+				const Vector fromEast = Ops::Or(Ops::template ShiftRight<1>(centerRows), Ops::template ShiftLeft<63>(Ops::Load(east + firstRow + dy)));
+
+				if (dy == 0)
+				{
+					neighbors[3] = fromWest;
+					neighbors[4] = fromEast;
+				}
+				else
+				{
+					const int base = dy < 0 ? 0 : 5;
+					neighbors[base] = fromWest;
+					neighbors[base + 1] = centerRows;
+					neighbors[base + 2] = fromEast;
+				}
+			}
+
+			const Vector next = ApplyRule<Ops>(current, CountNeighbors<Ops>(neighbors), rule);
+
+			const Vector padding = Ops::AndNot(interior, Ops::Load(output + firstRow));
+			Ops::Store(output + firstRow, Ops::Or(padding, Ops::And(interior, next)));
+		}
+	}
+
+	using StepStripFn = void (*)(const uint64_t* west, const uint64_t* center, const uint64_t* east, uint64_t* output, int rowCount, uint64_t interiorColumns, const RuleMasks& rule);
+
+	/// <summary>
+	/// The entry points all take the rule masks so they fit in a StepStripFn, but the ones built for a StaticRule don't need them
+	/// </summary>
+	template<class Rule>
+	GAMEBOARD_FORCE_INLINE Rule KernelRule(const RuleMasks&)
+	{
+		return Rule{};
+	}
+
+	template<>
+	GAMEBOARD_FORCE_INLINE RuleMasks KernelRule<RuleMasks>(const RuleMasks& rule)
+	{
+		return rule;
+	}
+
+	template<class Rule>
+	void StepStripScalar(const uint64_t* west, const uint64_t* center, const uint64_t* east, uint64_t* output, int rowCount, uint64_t interiorColumns, const RuleMasks& rule)
+	{
+		StepStrip<ScalarOps>(west, center, east, output, rowCount, interiorColumns, KernelRule<Rule>(rule));
+	}
+
+#if defined(GAMEBOARD_SIMD_X86)
+	template<class Rule>
+	GAMEBOARD_TARGET("sse2") GAMEBOARD_FLATTEN void StepStripSse2(const uint64_t* west, const uint64_t* center, const uint64_t* east, uint64_t* output, int rowCount, uint64_t interiorColumns, const RuleMasks& rule)
+	{
+		StepStrip<Sse2Ops>(west, center, east, output, rowCount, interiorColumns, KernelRule<Rule>(rule));
+	}
+
+	template<class Rule>
+	GAMEBOARD_TARGET("avx2") GAMEBOARD_FLATTEN void StepStripAvx2(const uint64_t* west, const uint64_t* center, const uint64_t* east, uint64_t* output, int rowCount, uint64_t interiorColumns, const RuleMasks& rule)
+	{
+		StepStrip<Avx2Ops>(west, center, east, output, rowCount, interiorColumns, KernelRule<Rule>(rule));
+	}
+
+	template<class Rule>
+	GAMEBOARD_TARGET("avx512f") GAMEBOARD_FLATTEN void StepStripAvx512(const uint64_t* west, const uint64_t* center, const uint64_t* east, uint64_t* output, int rowCount, uint64_t interiorColumns, const RuleMasks& rule)
+	{
+		StepStrip<Avx512Ops>(west, center, east, output, rowCount, interiorColumns, KernelRule<Rule>(rule));
+	}
+#endif
+
+	/// <summary>
+	/// Picks the widest kernel this machine can run, built for the rule if it's one of the compiled rules. The CPU only gets asked once,
+	/// the rule gets looked at whenever a board is handed a different one.
+	/// </summary>
+	inline StepStripFn SelectStepStripFn(const RuleMasks& rule)
+	{
+		static const SimdLevel detectedLevel = DetectSimdLevel();
+		const SimdLevel simdLevel = detectedLevel;
+
+		return DispatchRule(rule, [simdLevel](const auto& kernelRule) -> StepStripFn
+			{
+				using Rule = std::decay_t<decltype(kernelRule)>;
+				switch (simdLevel)
+				{
+#if defined(GAMEBOARD_SIMD_X86)
+				case SimdLevel::Avx512:
+					return &StepStripAvx512<Rule>;
+				case SimdLevel::Avx2:
+					return &StepStripAvx2<Rule>;
+				case SimdLevel::Sse2:
+					return &StepStripSse2<Rule>;
+#endif
+				default:
+					return &StepStripScalar<Rule>;
+				}
+			});
+	}
+}
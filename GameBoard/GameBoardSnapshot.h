@@ -0,0 +1,50 @@
+#pragma once
+#include "GameBoardInterface.h"
+#include <cstdint>
+
+/// <summary>
+/// The layout of a binary snapshot, shared by the writer in Output and the reader in Input. A snapshot is a SnapshotHeader followed by
+/// tiles, each a SnapshotTileHeader followed by size rows of SnapshotRowWords(size) words, and ends with a tile header whose size is 0.
+/// Rows are packed the same way GetCellRow and SetCellRow pack them, so a tile can go from the board to the file and back again a word at
+/// a time. Everything is 8 byte aligned and in the machine's byte order (little endian on everything we build for), so a mapped snapshot
+/// can be read right where it sits.
+/// </summary>
+namespace GameBoard
+{
+	constexpr char snapshotMagic[8] = { 'G', 'o', 'L', 'S', 'n', 'a', 'p', '\0' };
+
+	//Bump this whenever the layout changes, old snapshots get turned away rather than read wrong
+	constexpr uint32_t snapshotVersion = 1;
+
+	//Boards that aren't made of tiles get cut up into tiles this big, one word per row
+	constexpr Unit snapshotFallbackTileSize = 64;
+
+	//Anything bigger than this in a tile header is a broken file rather than a real tile
+	constexpr uint64_t snapshotMaximumTileSize = 1 << 16;
+
+	struct SnapshotHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint16_t birth;
+		uint16_t survive;
+		uint64_t generation;
+	};
+
+	struct SnapshotTileHeader
+	{
+		int64_t x;
+		int64_t y;
+		uint64_t size;
+	};
+
+	static_assert(sizeof(SnapshotHeader) == 24 && sizeof(SnapshotTileHeader) == 24, "Snapshot headers need to stay 8 byte aligned with no padding");
+
+	/// <summary>
+	/// How many words each row of a tile takes
+	/// </summary>
+	constexpr uint64_t SnapshotRowWords(uint64_t tileSize)
+	{
+		return (tileSize + 63) / 64;
+	}
+}
@@ -0,0 +1,284 @@
+#include "../GameBoardInterface.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace GameBoard;
+
+namespace
+{
+	struct TileSize
+	{
+		Unit size;
+		GameBoardCreationFn createSubBoard;
+	};
+
+	//Each of these is a power of two wide once you put the padding back on, so a row of a tile is a whole number of words
+	constexpr TileSize tileSizes[] = {
+		{ 6, &CreateStaticGridBoard6 },
+		{ 62, &CreateSimdGridBoard62 },
+		{ 254, &CreateSimdGridBoard },
+		{ 1022, &CreateSimdGridBoard1022 },
+	};
+	constexpr size_t tileSizeCount = sizeof(tileSizes) / sizeof(tileSizes[0]);
+
+	//Gliders and other small things spread out over a big area are the common case, so start with the small simd tiles until we know better
+	constexpr size_t startingTileSize = 1;
+
+	//How many generations we run between looks at the board. Looking costs about as much as a generation on the big tiles.
+	constexpr UnsignedUnit tuningInterval = 128;
+
+	//Roughly what it costs the multi grid to keep a tile around for a generation (hooking up neighbors, gathering padding, asking if it's
+	//empty) measured in the 64 cell words it could have stepped in that time instead
+	constexpr Unit tileOverheadWords = 120;
+
+	//Moving every cell over to new tiles isn't free, so only do it when the new size looks a good bit cheaper
+	constexpr Unit retileThresholdPercent = 75;
+
+	Unit FloorDivide(Unit value, Unit divisor)
+	{
+		const Unit quotient = value / divisor;
+		return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+	}
+
+	/// <summary>
+	/// A multi grid board that picks its own tile size. Small tiles waste the least time stepping empty space around sparse patterns like
+	/// glider fields, but every tile has a fixed cost on top of its cells, so dense soups want big tiles. Every so often we count how many
+	/// tiles of each size the live cells would land in, guess what a generation would cost on each, and if some other size would be a lot
+	/// cheaper, move the cells over to a new multi grid made of those.
+	/// The whole board uses one tile size. Regions with different densities using different sizes would need the padding exchange to work
+	/// between tiles that don't line up, which isn't worth it until patterns like that show up.
+	/// </summary>
+	class AdaptiveGridBoard : public IGameBoard
+	{
+	public:
+		AdaptiveGridBoard(unsigned workerCount) : m_workerCount(workerCount), m_tileSize(startingTileSize), m_generationsUntilTuning(0)
+		{
+			m_board = CreateMultiGridBoard(tileSizes[m_tileSize].createSubBoard, m_workerCount);
+		}
+
+		void Clear()
+		{
+			m_board->Clear();
+			m_generationsUntilTuning = 0;
+		}
+
+		bool Empty()
+		{
+			return m_board->Empty();
+		}
+
+		bool GetCell(const Coord& position) const
+		{
+			return m_board->GetCell(position);
+		}
+
+		bool GetCurrentCell(const Coord& position) const
+		{
+			return m_board->GetCurrentCell(position);
+		}
+
+		void SetCell(const Coord& position, bool value)
+		{
+			m_board->SetCell(position, value);
+		}
+
+		void SetCells(std::span<const Coord> cells, bool value)
+		{
+			m_board->SetCells(cells, value);
+		}
+
+		void SetCellRun(const Coord& start, Unit length, bool value)
+		{
+			m_board->SetCellRun(start, length, value);
+		}
+
+		void GetCellRow(const Coord& start, Unit length, uint64_t* bits) const
+		{
+			m_board->GetCellRow(start, length, bits);
+		}
+
+		void SetCellRow(const Coord& start, Unit length, const uint64_t* bits)
+		{
+			m_board->SetCellRow(start, length, bits);
+		}
+
+		Unit MaximumBoardLength()
+		{
+			return m_board->MaximumBoardLength();
+		}
+
+		/// <summary>
+		/// Finishes the generation, and every tuningInterval generations sees if the board would be better off with a different tile size.
+		/// The first look is right after the board gets loaded.
+		/// </summary>
+		void FinishCurrentGeneration()
+		{
+			m_board->FinishCurrentGeneration();
+
+			if (m_generationsUntilTuning == 0)
+			{
+				Instrumentation::ScopedPhase retileTimer(Instrumentation::Phase::Retile);
+				Tune();
+				m_generationsUntilTuning = tuningInterval;
+			}
+			--m_generationsUntilTuning;
+		}
+
+		bool CurrentGenerationChanged() const
+		{
+			return m_board->CurrentGenerationChanged();
+		}
+
+		void IterateCurrentGenerationBoard(const RuleMasks& rule)
+		{
+			m_board->IterateCurrentGenerationBoard(rule);
+		}
+
+		/// <summary>
+		/// Includes the boards we've already retiled away from, so the numbers only ever go up
+		/// </summary>
+		PoolStats GetPoolStats() const
+		{
+			const PoolStats stats = m_board->GetPoolStats();
+			return PoolStats{ m_retiredPoolStats.hits + stats.hits, m_retiredPoolStats.misses + stats.misses };
+		}
+
+		UnsignedUnit GetBytesResident() const
+		{
+			UnsignedUnit bytes = sizeof(*this) + m_board->GetBytesResident();
+			for (const auto& tiles : m_occupiedTiles)
+			{
+				bytes += tiles.capacity() * sizeof(Coord);
+			}
+			return bytes;
+		}
+
+		void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const
+		{
+			m_board->IterateCurrentGenerationAliveCells(parentCoord, fn);
+		}
+
+		void CollectCurrentGenerationAliveCells(const Coord& parentCoord, AliveCellBlock& block) const
+		{
+			m_board->CollectCurrentGenerationAliveCells(parentCoord, block);
+		}
+
+		void GetSortedAliveCells(std::vector<Coord>& cells) const
+		{
+			m_board->GetSortedAliveCells(cells);
+		}
+
+		bool IterateTiles(TileIteratorFn fn) const
+		{
+			return m_board->IterateTiles(fn);
+		}
+
+		UnsignedUnit GetBoardHash() const
+		{
+			return m_board->GetBoardHash();
+		}
+
+		UnsignedUnit GetPopulation() const
+		{
+			return m_board->GetPopulation();
+		}
+
+		bool GetBoundingBox(Coord& min, Coord& max) const
+		{
+			return m_board->GetBoundingBox(min, max);
+		}
+
+	private:
+		/// <summary>
+		/// Works out how many tiles of each size the live cells fall in, and moves to the size with the cheapest guess if it's enough of
+		/// an improvement. Cells come out of the multi grid a tile at a time and a row at a time, so runs of cells in the same tile are
+		/// skipped as they go by without working out which tile they're in, and only what's left gets sorted.
+		/// </summary>
+		void Tune()
+		{
+			for (auto& tiles : m_occupiedTiles)
+			{
+				tiles.clear();
+			}
+
+			//Where the last tile we pushed for each size starts, so cells that land in it again can be skipped with a couple of compares
+			//rather than dividing. Cells can't be this far out, so nothing matches before the first push.
+			Coord lastTileOrigins[tileSizeCount];
+			std::fill(lastTileOrigins, lastTileOrigins + tileSizeCount, Coord{ std::numeric_limits<Unit>::min(), std::numeric_limits<Unit>::min() });
+
+			ForEachAliveCell(*m_board, [this, &lastTileOrigins](const Coord& cell)
+				{
+					for (size_t i = 0; i < tileSizeCount; ++i)
+					{
+						const UnsignedUnit size = static_cast<UnsignedUnit>(tileSizes[i].size);
+						Coord& origin = lastTileOrigins[i];
+						if (static_cast<UnsignedUnit>(cell.x) - static_cast<UnsignedUnit>(origin.x) < size &&
+							static_cast<UnsignedUnit>(cell.y) - static_cast<UnsignedUnit>(origin.y) < size)
+						{
+							continue;
+						}
+
+						const Coord tile{ FloorDivide(cell.x, tileSizes[i].size), FloorDivide(cell.y, tileSizes[i].size) };
+						origin = Coord{ tile.x * tileSizes[i].size, tile.y * tileSizes[i].size };
+						m_occupiedTiles[i].push_back(tile);
+					}
+				});
+
+			if (m_occupiedTiles[0].empty())
+			{
+				return;
+			}
+
+			Unit costs[tileSizeCount];
+			for (size_t i = 0; i < tileSizeCount; ++i)
+			{
+				auto& tiles = m_occupiedTiles[i];
+				std::sort(tiles.begin(), tiles.end(), LessCoord());
+				const Unit tileCount = std::unique(tiles.begin(), tiles.end(), [](const Coord& a, const Coord& b) { return a.x == b.x && a.y == b.y; }) - tiles.begin();
+
+				const Unit wordsPerTile = (tileSizes[i].size + 2) * (tileSizes[i].size + 2) / 64;
+				costs[i] = tileCount * (wordsPerTile + tileOverheadWords);
+			}
+
+			const size_t cheapest = std::min_element(costs, costs + tileSizeCount) - costs;
+
+			if (cheapest != m_tileSize && costs[cheapest] * 100 < costs[m_tileSize] * retileThresholdPercent)
+			{
+				Retile(cheapest);
+			}
+		}
+
+		/// <summary>
+		/// Moves the current generation over to a new multi grid with a different tile size, the same way a board gets loaded
+		/// </summary>
+		void Retile(size_t tileSize)
+		{
+			std::vector<Coord> cells;
+			ForEachAliveCell(*m_board, [&cells](const Coord& cell) { cells.push_back(cell); });
+
+			const PoolStats stats = m_board->GetPoolStats();
+			m_retiredPoolStats.hits += stats.hits;
+			m_retiredPoolStats.misses += stats.misses;
+
+			m_tileSize = tileSize;
+			m_board = CreateMultiGridBoard(tileSizes[m_tileSize].createSubBoard, m_workerCount);
+			m_board->SetCells(cells, true);
+			m_board->FinishCurrentGeneration();
+		}
+
+		unsigned m_workerCount;
+		size_t m_tileSize;
+		UnsignedUnit m_generationsUntilTuning;
+		IGameBoardPtr m_board;
+		PoolStats m_retiredPoolStats;
+
+		//Kept around between looks so counting doesn't have to allocate
+		Memory::TrackedVector<Coord, Memory::Subsystem::Tiles> m_occupiedTiles[tileSizeCount];
+	};
+}
+
+IGameBoardPtr GameBoard::CreateAdaptiveGridBoard(unsigned workerCount)
+{
+	return std::make_unique<AdaptiveGridBoard>(workerCount);
+}
@@ -0,0 +1,817 @@
+#include "../GameBoardInterface.h"
+#include "../GameBoardRules.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace GameBoard;
+
+namespace
+{
+	//Nodes at this level are 8x8 squares stored directly as the bits of a 64 bit word instead of having children
+	constexpr int leafLevel = 3;
+
+	//Nodes up to this level (32x32) are small enough to step by just running the rule on their rows
+	constexpr int bruteForceLevel = 5;
+
+	//The root never gets smaller than 64x64, and can't get bigger than the whole 64 bit space. Stepping a root that big goes through a
+	//node one level bigger again, made of copies of it (see WrapAround).
+	constexpr int minimumRootLevel = 6;
+	constexpr int maximumRootLevel = 64;
+
+	//How many nodes we let pile up before throwing away everything the current generation doesn't use
+	constexpr size_t minimumGarbageCollectionNodeCount = 1 << 22;
+
+	/// <summary>
+	/// A square of 2^level x 2^level cells. Nodes are hash consed, meaning there is only ever one node for any given arrangement of cells,
+	/// so two nodes are the same pattern exactly when they are the same pointer. Nodes never change after being made.
+	/// </summary>
+	struct Node
+	{
+		Node* nw;
+		Node* ne;
+		Node* sw;
+		Node* se;
+
+		//Only used by leaves. Bit (y * 8 + x) is the cell at (x, y)
+		uint64_t leafBits;
+
+		UnsignedUnit population;
+
+		//The center 2^(level-1) square of this node, 2^(level-2) generations later. Filled in the first time someone asks.
+		Node* result;
+
+		int level;
+	};
+
+	struct ChildrenKey
+	{
+		const Node* nw;
+		const Node* ne;
+		const Node* sw;
+		const Node* se;
+
+		bool operator==(const ChildrenKey&) const = default;
+	};
+
+	class HashChildrenKey
+	{
+	public:
+		size_t operator()(const ChildrenKey& key) const
+		{
+			uint64_t hash = MixBits(reinterpret_cast<uintptr_t>(key.nw));
+			hash = MixBits(hash ^ reinterpret_cast<uintptr_t>(key.ne));
+			hash = MixBits(hash ^ reinterpret_cast<uintptr_t>(key.sw));
+			return MixBits(hash ^ reinterpret_cast<uintptr_t>(key.se));
+		}
+	};
+
+	struct StepKey
+	{
+		const Node* node;
+		int log2Generations;
+
+		bool operator==(const StepKey&) const = default;
+	};
+
+	class HashStepKey
+	{
+	public:
+		size_t operator()(const StepKey& key) const
+		{
+			return MixBits(reinterpret_cast<uintptr_t>(key.node) ^ key.log2Generations);
+		}
+	};
+
+	class HashLeafBits
+	{
+	public:
+		size_t operator()(uint64_t bits) const
+		{
+			return MixBits(bits);
+		}
+	};
+
+	//The nodes and every table that finds them are counted together, since they grow and get collected together
+	using NodeStore = std::deque<Node, Memory::TrackingAllocator<Node, Memory::Subsystem::Nodes>>;
+
+	template<class Key, class Hash = std::hash<Key>>
+	using NodeTable = std::unordered_map<Key, Node*, Hash, std::equal_to<Key>, Memory::TrackingAllocator<std::pair<const Key, Node*>, Memory::Subsystem::Nodes>>;
+
+	/// <summary>
+	/// This is the real quadtree I was thinking about. The whole board is a single tree of nodes, and since nodes are shared between
+	/// every place the same pattern shows up, and every node remembers what it turns into, repeating patterns only ever get simulated once.
+	/// The trick is that a node of size 2^k can work out its center 2^(k-2) generations into the future from the futures of its sub-nodes,
+	/// which means the number of generations we can step at once doubles with each level of the tree.
+	///
+	/// The root is always centered on (0, 0), covering [-2^(level-1), 2^(level-1)) in both directions, and grows as cells get further out.
+	/// The top level is the whole 64 bit space, and it wraps around at the edges the same as coordinates do, so a cell walking off one
+	/// side comes back on the other rather than being lost.
+	///
+	/// This only works for rules where empty space stays empty (no birth on 0 neighbors), the same as the grid boards.
+	/// </summary>
+	class HashLifeBoard : public IGameBoard
+	{
+	public:
+		HashLifeBoard() : m_boundsRoot(nullptr), m_garbageCollectionNodeCount(minimumGarbageCollectionNodeCount)
+		{
+			Clear();
+		}
+
+		void Clear()
+		{
+			m_steps.clear();
+			m_branches.clear();
+			m_leaves.clear();
+			m_emptyNodes.clear();
+			m_nodes.clear();
+
+			m_root = EmptyNode(minimumRootLevel);
+			m_current = m_root;
+			m_boundsRoot = nullptr;
+		}
+
+		/// <summary>
+		/// Same as the grid boards, we're only empty if neither the finished generation nor the one being written have cells
+		/// </summary>
+		bool Empty()
+		{
+			return m_root->population == 0 && m_current->population == 0;
+		}
+
+		/// <summary>
+		/// Walks down the tree to the leaf holding the cell. Any node with no population is all dead cells so we can stop early.
+		/// </summary>
+		bool GetCell(const Coord& position) const
+		{
+			return FindCell(m_root, position);
+		}
+
+		/// <summary>
+		/// Walks down the tree to the leaf holding the cell in the generation being written.
+		/// </summary>
+		bool GetCurrentCell(const Coord& position) const
+		{
+			return FindCell(m_current, position);
+		}
+
+		/// <summary>
+		/// Nodes never change, so setting a cell makes a new copy of every node on the path from the root down to its leaf.
+		/// If the cell is outside the tree, the tree gets bigger until it isn't.
+		/// </summary>
+		void SetCell(const Coord& position, bool value)
+		{
+			while (!Contains(m_current, position))
+			{
+				//Nothing to clear out there
+				if (!value)
+				{
+					return;
+				}
+				m_current = Expand(m_current);
+			}
+
+			const UnsignedUnit originOffset = 1ull << (m_current->level - 1);
+			m_current = SetCellInternal(m_current, static_cast<UnsignedUnit>(position.x) + originOffset, static_cast<UnsignedUnit>(position.y) + originOffset, value);
+		}
+
+		/// <summary>
+		/// We should support any grid location in the 64 bit space
+		/// </summary>
+		/// <returns>maximum allowable length</returns>
+		Unit MaximumBoardLength()
+		{
+			return std::numeric_limits<Unit>::max();
+		}
+
+		/// <summary>
+		/// The nodes plus the tables that find them again. Each table entry is a heap node with a next pointer and the cached hash,
+		/// and every bucket is a pointer.
+		/// </summary>
+		UnsignedUnit GetBytesResident() const
+		{
+			auto tableBytes = [](const auto& table)
+				{
+					using Entry = typename std::remove_reference_t<decltype(table)>::value_type;
+					return table.size() * (sizeof(Entry) + 2 * sizeof(void*)) + table.bucket_count() * sizeof(void*);
+				};
+
+			return sizeof(*this) + m_nodes.size() * sizeof(Node) + tableBytes(m_leaves) + tableBytes(m_branches) + tableBytes(m_steps) +
+				m_emptyNodes.capacity() * sizeof(Node*);
+		}
+
+		/// <summary>
+		/// The generation we were writing becomes the one everyone reads. Nothing is copied since both are just roots of the same tree.
+		/// </summary>
+		void FinishCurrentGeneration()
+		{
+			m_root = m_current;
+			CollectGarbageIfNeeded();
+		}
+
+		/// <summary>
+		/// Steps a single generation
+		/// </summary>
+		/// <param name="rule">The rule to run the game of life with</param>
+		void IterateCurrentGenerationBoard(const RuleMasks& rule)
+		{
+			UpdateRule(rule);
+			m_current = Advance(m_root, 1);
+		}
+
+		/// <summary>
+		/// This is what the board is for. The generation count gets broken up into powers of two and each of those is a single step
+		/// through the tree, so a billion generations is about 30 steps.
+		/// </summary>
+		void IterateGenerations(const RuleMasks& rule, UnsignedUnit generations)
+		{
+			UpdateRule(rule);
+			{
+				Instrumentation::ScopedPhase stepTimer(Instrumentation::Phase::Step);
+				m_current = Advance(m_root, generations);
+			}
+			FinishCurrentGeneration();
+			Instrumentation::EndGeneration(*this, generations);
+		}
+
+		/// <summary>
+		/// Walks the tree, skipping any node that has no population.
+		/// </summary>
+		/// <param name="fn">The function to run on all the alive cells.</param>
+		void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const
+		{
+			const UnsignedUnit origin = 0ull - (1ull << (m_root->level - 1));
+			VisitAliveCells(m_root, origin + static_cast<UnsignedUnit>(parentCoord.x), origin + static_cast<UnsignedUnit>(parentCoord.y), fn);
+		}
+
+		/// <summary>
+		/// Same walk, with the leaves pushed straight into the block
+		/// </summary>
+		void CollectCurrentGenerationAliveCells(const Coord& parentCoord, AliveCellBlock& block) const
+		{
+			const UnsignedUnit origin = 0ull - (1ull << (m_root->level - 1));
+			auto push = [&block](const Coord& cell) { block.Push(cell); };
+			VisitAliveCells(m_root, origin + static_cast<UnsignedUnit>(parentCoord.x), origin + static_cast<UnsignedUnit>(parentCoord.y), push);
+		}
+
+		/// <summary>
+		/// Every node knows its population, so this is just the root's
+		/// </summary>
+		UnsignedUnit GetPopulation() const
+		{
+			return m_root->population;
+		}
+
+		/// <summary>
+		/// Follows each side of the pattern down the tree, then remembers the answer until the root changes
+		/// </summary>
+		bool GetBoundingBox(Coord& min, Coord& max) const
+		{
+			if (m_root->population == 0)
+			{
+				return false;
+			}
+
+			if (m_boundsRoot != m_root)
+			{
+				const UnsignedUnit origin = 0ull - (1ull << (m_root->level - 1));
+				//The far side of the root, which is the whole space at the top level so it can't be worked out as origin + size
+				const UnsignedUnit last = origin + (~0ull >> (64 - m_root->level));
+				m_boundsMin = Coord{ static_cast<Unit>(origin + DistanceFromSide(m_root, false, false)), static_cast<Unit>(origin + DistanceFromSide(m_root, true, false)) };
+				m_boundsMax = Coord{ static_cast<Unit>(last - DistanceFromSide(m_root, false, true) + 1), static_cast<Unit>(last - DistanceFromSide(m_root, true, true) + 1) };
+				m_boundsRoot = m_root;
+			}
+
+			min = m_boundsMin;
+			max = m_boundsMax;
+			return true;
+		}
+
+	private:
+		//////////////////////////////////////////////////////////////////////////
+		// Making nodes
+
+		Node* Leaf(uint64_t bits)
+		{
+			auto found = m_leaves.find(bits);
+			if (found != m_leaves.end())
+			{
+				return found->second;
+			}
+
+			Node* leaf = &m_nodes.emplace_back(Node{ nullptr, nullptr, nullptr, nullptr, bits, static_cast<UnsignedUnit>(std::popcount(bits)), nullptr, leafLevel });
+			m_leaves.emplace(bits, leaf);
+			return leaf;
+		}
+
+		Node* Join(Node* nw, Node* ne, Node* sw, Node* se)
+		{
+			const ChildrenKey key{ nw, ne, sw, se };
+			auto found = m_branches.find(key);
+			if (found != m_branches.end())
+			{
+				return found->second;
+			}
+
+			const UnsignedUnit population = nw->population + ne->population + sw->population + se->population;
+			Node* branch = &m_nodes.emplace_back(Node{ nw, ne, sw, se, 0, population, nullptr, nw->level + 1 });
+			m_branches.emplace(key, branch);
+			return branch;
+		}
+
+		Node* EmptyNode(int level)
+		{
+			if (m_emptyNodes.size() <= static_cast<size_t>(level))
+			{
+				m_emptyNodes.resize(level + 1, nullptr);
+			}
+
+			if (m_emptyNodes[level] == nullptr)
+			{
+				if (level == leafLevel)
+				{
+					m_emptyNodes[level] = Leaf(0);
+				}
+				else
+				{
+					Node* child = EmptyNode(level - 1);
+					m_emptyNodes[level] = Join(child, child, child, child);
+				}
+			}
+
+			return m_emptyNodes[level];
+		}
+
+		/// <summary>
+		/// Makes a node one level bigger with this node in the middle of it
+		/// </summary>
+		Node* Expand(Node* node)
+		{
+			Node* empty = EmptyNode(node->level - 1);
+			return Join(Join(empty, empty, empty, node->nw),
+				Join(empty, empty, node->ne, empty),
+				Join(empty, node->sw, empty, empty),
+				Join(node->se, empty, empty, empty));
+		}
+
+		/// <summary>
+		/// A node twice the size of a top level root, tiled with copies of it so that its middle half is the root again. Stepping this
+		/// steps the root as the wrapping 64 bit space it really is, since the cells just past each edge are the ones from the far side.
+		/// Every quadrant of it is the same node, the root with its quadrants swapped diagonally.
+		/// </summary>
+		Node* WrapAround(Node* root)
+		{
+			Node* const swapped = Join(root->se, root->sw, root->ne, root->nw);
+			return Join(swapped, swapped, swapped, swapped);
+		}
+
+		/// <summary>
+		/// The middle half of a node, one level down. Needs the node to be at least two levels above the leaves.
+		/// </summary>
+		Node* Centre(Node* node)
+		{
+			return Join(node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// Cells
+
+		/// <summary>
+		/// Checks if a coordinate is inside the square a root node covers
+		/// </summary>
+		static bool Contains(const Node* root, const Coord& position)
+		{
+			if (root->level >= maximumRootLevel)
+			{
+				return true;
+			}
+
+			const UnsignedUnit originOffset = 1ull << (root->level - 1);
+			const UnsignedUnit size = 1ull << root->level;
+			return static_cast<UnsignedUnit>(position.x) + originOffset < size && static_cast<UnsignedUnit>(position.y) + originOffset < size;
+		}
+
+		static bool FindCell(const Node* root, const Coord& position)
+		{
+			if (!Contains(root, position))
+			{
+				return false;
+			}
+
+			const UnsignedUnit originOffset = 1ull << (root->level - 1);
+			UnsignedUnit x = static_cast<UnsignedUnit>(position.x) + originOffset;
+			UnsignedUnit y = static_cast<UnsignedUnit>(position.y) + originOffset;
+
+			const Node* node = root;
+			while (node->level > leafLevel)
+			{
+				if (node->population == 0)
+				{
+					return false;
+				}
+
+				const UnsignedUnit half = 1ull << (node->level - 1);
+				const bool east = x >= half;
+				const bool south = y >= half;
+				node = south ? (east ? node->se : node->sw) : (east ? node->ne : node->nw);
+				x -= east ? half : 0;
+				y -= south ? half : 0;
+			}
+
+			return (node->leafBits >> (y * 8 + x)) & 1;
+		}
+
+		/// <summary>
+		/// Rebuilds the path down to the cell at (x, y), relative to the node's top left corner
+		/// </summary>
+		Node* SetCellInternal(Node* node, UnsignedUnit x, UnsignedUnit y, bool value)
+		{
+			if (node->level == leafLevel)
+			{
+				const uint64_t bit = 1ull << (y * 8 + x);
+				return Leaf(value ? (node->leafBits | bit) : (node->leafBits & ~bit));
+			}
+
+			const UnsignedUnit half = 1ull << (node->level - 1);
+			const bool east = x >= half;
+			const bool south = y >= half;
+			x -= east ? half : 0;
+			y -= south ? half : 0;
+
+			if (south)
+			{
+				return east ? Join(node->nw, node->ne, node->sw, SetCellInternal(node->se, x, y, value))
+					: Join(node->nw, node->ne, SetCellInternal(node->sw, x, y, value), node->se);
+			}
+			return east ? Join(node->nw, SetCellInternal(node->ne, x, y, value), node->sw, node->se)
+				: Join(SetCellInternal(node->nw, x, y, value), node->ne, node->sw, node->se);
+		}
+
+		/// <summary>
+		/// Depth first walk over the live cells. (x, y) is the node's top left corner, and is unsigned so that walking off the
+		/// top of the 64 bit space at the root level wraps around to the right place.
+		/// </summary>
+		template<class CellFn>
+		static void VisitAliveCells(const Node* node, UnsignedUnit x, UnsignedUnit y, CellFn& fn)
+		{
+			if (node->population == 0)
+			{
+				return;
+			}
+
+			if (node->level == leafLevel)
+			{
+				uint64_t bits = node->leafBits;
+				while (bits != 0)
+				{
+					const int bit = std::countr_zero(bits);
+					bits &= bits - 1;
+
+					fn(Coord{ static_cast<Unit>(x + bit % 8), static_cast<Unit>(y + bit / 8) });
+				}
+				return;
+			}
+
+			const UnsignedUnit half = 1ull << (node->level - 1);
+			VisitAliveCells(node->nw, x, y, fn);
+			VisitAliveCells(node->ne, x + half, y, fn);
+			VisitAliveCells(node->sw, x, y + half, fn);
+			VisitAliveCells(node->se, x + half, y + half, fn);
+		}
+
+		/// <summary>
+		/// How many rows or columns in from one side of a node its nearest live cell is. Only the two children on that side get looked at
+		/// unless they're both empty, so this follows the edge of the pattern down the tree instead of walking all of it.
+		/// </summary>
+		/// <param name="rows">Count rows in from the top or bottom, rather than columns in from the left or right</param>
+		/// <param name="fromFar">Count from the bottom or right rather than the top or left</param>
+		static UnsignedUnit DistanceFromSide(const Node* node, bool rows, bool fromFar)
+		{
+			if (node->level == leafLevel)
+			{
+				//Bit i is set if row or column i has a cell in it
+				uint64_t lines = 0;
+				for (int row = 0; row < 8; ++row)
+				{
+					const uint64_t rowBits = (node->leafBits >> (row * 8)) & 0xFF;
+					lines |= rows ? static_cast<uint64_t>(rowBits != 0) << row : rowBits;
+				}
+				return fromFar ? std::countl_zero(lines) - 56 : std::countr_zero(lines);
+			}
+
+			//The two children along each side, top or left first, then bottom or right
+			const Node* const sides[2][2] = { { node->nw, rows ? node->ne : node->sw }, { node->se, rows ? node->sw : node->ne } };
+			auto nearest = [rows, fromFar](const Node* const (&side)[2])
+				{
+					UnsignedUnit distance = std::numeric_limits<UnsignedUnit>::max();
+					for (const Node* child : side)
+					{
+						if (child->population != 0)
+						{
+							distance = std::min(distance, DistanceFromSide(child, rows, fromFar));
+						}
+					}
+					return distance;
+				};
+
+			const UnsignedUnit distance = nearest(sides[fromFar]);
+			if (distance != std::numeric_limits<UnsignedUnit>::max())
+			{
+				return distance;
+			}
+			return (1ull << (node->level - 1)) + nearest(sides[!fromFar]);
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// Stepping
+
+		/// <summary>
+		/// Everything we've remembered about the future depends on the rule, so if the rule changes it all has to go
+		/// </summary>
+		void UpdateRule(const RuleMasks& rule)
+		{
+			if (rule != m_rule)
+			{
+				m_rule = rule;
+				for (Node& node : m_nodes)
+				{
+					node.result = nullptr;
+				}
+				m_steps.clear();
+			}
+		}
+
+		/// <summary>
+		/// Steps a root by any number of generations, one power of two at a time
+		/// </summary>
+		Node* Advance(Node* root, UnsignedUnit generations)
+		{
+			for (int log2Generations = 0; generations != 0; ++log2Generations, generations >>= 1)
+			{
+				if (generations & 1)
+				{
+					root = AdvancePowerOfTwo(root, log2Generations);
+				}
+			}
+			return root;
+		}
+
+		/// <summary>
+		/// Steps a root by 2^log2Generations. The root has to be big enough that the pattern can't grow out of the middle half
+		/// we get back, which means the pattern has to sit in the middle quarter and the root has to be at least 8 times as big as
+		/// the number of generations. Once the root is the whole space and that still isn't true, we step the wrapped copies of it
+		/// instead, whose middle half is the whole space.
+		/// </summary>
+		Node* AdvancePowerOfTwo(Node* root, int log2Generations)
+		{
+			while (root->level < maximumRootLevel && (root->level < log2Generations + 3 || !IsCentred(root)))
+			{
+				root = Expand(root);
+			}
+
+			if (root->level >= maximumRootLevel && (root->level < log2Generations + 3 || !IsCentred(root)))
+			{
+				root = WrapAround(root);
+			}
+
+			root = Successor(root, log2Generations);
+
+			while (root->level < minimumRootLevel)
+			{
+				root = Expand(root);
+			}
+			return root;
+		}
+
+		/// <summary>
+		/// True if all the population of a node is in its middle quarter
+		/// </summary>
+		static bool IsCentred(const Node* node)
+		{
+			return node->population == node->nw->se->se->population + node->ne->sw->sw->population +
+				node->sw->ne->ne->population + node->se->nw->nw->population;
+		}
+
+		/// <summary>
+		/// The heart of hashlife. Returns the middle half of a node 2^log2Generations generations later, where log2Generations can be
+		/// at most level - 2. We split the node into 9 overlapping sub-nodes one level down and step each of them. If we were asked for the
+		/// full 2^(level-2) generations, we step those results a second time, otherwise the middles of the results are the answer.
+		/// </summary>
+		Node* Successor(Node* node, int log2Generations)
+		{
+			const int level = node->level;
+			if (node->population == 0)
+			{
+				return EmptyNode(level - 1);
+			}
+
+			const bool fullStep = log2Generations == level - 2;
+			if (fullStep && node->result != nullptr)
+			{
+				return node->result;
+			}
+			if (!fullStep)
+			{
+				auto found = m_steps.find(StepKey{ node, log2Generations });
+				if (found != m_steps.end())
+				{
+					return found->second;
+				}
+			}
+
+			Node* result = nullptr;
+			if (level <= bruteForceLevel)
+			{
+				result = BruteForce(node, 1u << log2Generations);
+			}
+			else
+			{
+				Node* const nw = node->nw;
+				Node* const ne = node->ne;
+				Node* const sw = node->sw;
+				Node* const se = node->se;
+
+				const int childLog2Generations = std::min(log2Generations, level - 3);
+				Node* const c00 = Successor(nw, childLog2Generations);
+				Node* const c01 = Successor(Join(nw->ne, ne->nw, nw->se, ne->sw), childLog2Generations);
+				Node* const c02 = Successor(ne, childLog2Generations);
+				Node* const c10 = Successor(Join(nw->sw, nw->se, sw->nw, sw->ne), childLog2Generations);
+				Node* const c11 = Successor(Centre(node), childLog2Generations);
+				Node* const c12 = Successor(Join(ne->sw, ne->se, se->nw, se->ne), childLog2Generations);
+				Node* const c20 = Successor(sw, childLog2Generations);
+				Node* const c21 = Successor(Join(sw->ne, se->nw, sw->se, se->sw), childLog2Generations);
+				Node* const c22 = Successor(se, childLog2Generations);
+
+				if (fullStep)
+				{
+					result = Join(Successor(Join(c00, c01, c10, c11), childLog2Generations),
+						Successor(Join(c01, c02, c11, c12), childLog2Generations),
+						Successor(Join(c10, c11, c20, c21), childLog2Generations),
+						Successor(Join(c11, c12, c21, c22), childLog2Generations));
+				}
+				else
+				{
+					result = Join(Centre(Join(c00, c01, c10, c11)),
+						Centre(Join(c01, c02, c11, c12)),
+						Centre(Join(c10, c11, c20, c21)),
+						Centre(Join(c11, c12, c21, c22)));
+				}
+			}
+
+			if (fullStep)
+			{
+				node->result = result;
+			}
+			else
+			{
+				m_steps.emplace(StepKey{ node, log2Generations }, result);
+			}
+			return result;
+		}
+
+		/// <summary>
+		/// At the bottom of the tree we just lay the node out as rows of bits and run the rule on them. Each generation the cells at the
+		/// edge of what we laid out are wrong since we can't see their neighbors, but we only keep the middle half so that doesn't matter.
+		/// </summary>
+		Node* BruteForce(const Node* node, unsigned int generations)
+		{
+			const int size = 1 << node->level;
+			const uint64_t rowMask = (1ull << size) - 1;
+
+			uint64_t rows[1 << bruteForceLevel] = {};
+			FillRows(node, 0, 0, rows);
+
+			DispatchRule(m_rule, [&rows, size, rowMask, generations](const auto& rule)
+				{
+					for (unsigned int generation = 0; generation < generations; ++generation)
+					{
+						uint64_t nextRows[1 << bruteForceLevel];
+						for (int row = 0; row < size; ++row)
+						{
+							const uint64_t up = row > 0 ? rows[row - 1] : 0;
+							const uint64_t current = rows[row];
+							const uint64_t down = row + 1 < size ? rows[row + 1] : 0;
+							const uint64_t neighbors[8] = { up << 1, up, up >> 1, current << 1, current >> 1, down << 1, down, down >> 1 };
+
+							nextRows[row] = NextGeneration(current, neighbors, rule) & rowMask;
+						}
+						std::copy(nextRows, nextRows + size, rows);
+					}
+				});
+
+			return NodeFromRows(rows, size / 4, size / 4, node->level - 1);
+		}
+
+		static void FillRows(const Node* node, int x, int y, uint64_t* rows)
+		{
+			if (node->level == leafLevel)
+			{
+				for (int row = 0; row < 8; ++row)
+				{
+					rows[y + row] |= ((node->leafBits >> (row * 8)) & 0xff) << x;
+				}
+				return;
+			}
+
+			const int half = 1 << (node->level - 1);
+			FillRows(node->nw, x, y, rows);
+			FillRows(node->ne, x + half, y, rows);
+			FillRows(node->sw, x, y + half, rows);
+			FillRows(node->se, x + half, y + half, rows);
+		}
+
+		Node* NodeFromRows(const uint64_t* rows, int x, int y, int level)
+		{
+			if (level == leafLevel)
+			{
+				uint64_t bits = 0;
+				for (int row = 0; row < 8; ++row)
+				{
+					bits |= ((rows[y + row] >> x) & 0xff) << (row * 8);
+				}
+				return Leaf(bits);
+			}
+
+			const int half = 1 << (level - 1);
+			return Join(NodeFromRows(rows, x, y, level - 1), NodeFromRows(rows, x + half, y, level - 1),
+				NodeFromRows(rows, x, y + half, level - 1), NodeFromRows(rows, x + half, y + half, level - 1));
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// Memory
+
+		/// <summary>
+		/// Nodes are never freed on their own, since anything could be pointing at them. Once there are too many, copy what the two
+		/// generations we're holding on to use into fresh tables and drop everything else, including everything we remembered about
+		/// the future. Only done between generations so nobody is holding on to a node while it happens.
+		/// </summary>
+		void CollectGarbageIfNeeded()
+		{
+			if (m_nodes.size() < m_garbageCollectionNodeCount)
+			{
+				return;
+			}
+
+			NodeStore oldNodes;
+			oldNodes.swap(m_nodes);
+			m_steps.clear();
+			m_branches.clear();
+			m_leaves.clear();
+			m_emptyNodes.clear();
+
+			//The old root is about to go, and a new node could end up where it was
+			m_boundsRoot = nullptr;
+
+			NodeTable<const Node*> copies;
+			m_root = CopyNode(m_root, copies);
+			m_current = CopyNode(m_current, copies);
+
+			//If most of what we have is still in use, give ourselves more room before trying again
+			m_garbageCollectionNodeCount = std::max(minimumGarbageCollectionNodeCount, m_nodes.size() * 2);
+		}
+
+		Node* CopyNode(const Node* node, NodeTable<const Node*>& copies)
+		{
+			auto found = copies.find(node);
+			if (found != copies.end())
+			{
+				return found->second;
+			}
+
+			Node* copy = node->level == leafLevel ? Leaf(node->leafBits) :
+				Join(CopyNode(node->nw, copies), CopyNode(node->ne, copies), CopyNode(node->sw, copies), CopyNode(node->se, copies));
+			copies.emplace(node, copy);
+			return copy;
+		}
+
+		//The finished generation, and the one being written
+		Node* m_root;
+		Node* m_current;
+
+		//Every node lives here. A deque so that adding nodes never moves the ones we have.
+		NodeStore m_nodes;
+		NodeTable<uint64_t, HashLeafBits> m_leaves;
+		NodeTable<ChildrenKey, HashChildrenKey> m_branches;
+		Memory::TrackedVector<Node*, Memory::Subsystem::Nodes> m_emptyNodes;
+
+		//Results for steps smaller than a node's full step. Full steps live on the node itself.
+		NodeTable<StepKey, HashStepKey> m_steps;
+
+		//The root GetBoundingBox last worked out the bounds for, and what they were
+		mutable const Node* m_boundsRoot;
+		mutable Coord m_boundsMin;
+		mutable Coord m_boundsMax;
+
+		RuleMasks m_rule;
+		size_t m_garbageCollectionNodeCount;
+	};
+}
+
+IGameBoardPtr GameBoard::CreateHashLifeBoard()
+{
+	return std::make_unique<HashLifeBoard>();
+}
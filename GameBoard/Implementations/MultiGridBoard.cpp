@@ -1,13 +1,35 @@
 #include "../GameBoardInterface.h"
-#include <map>
+#include "../ThreadPool.h"
+#include <algorithm>
+#include <vector>
 
 using namespace GameBoard;
 
 namespace
 {
+	/// <summary>
+	/// How many words a grid's packed edges take, a row or column for each side
+	/// </summary>
+	size_t EdgeWordCount(Unit gridSize)
+	{
+		return 4 * EdgeWords(gridSize);
+	}
+
+	/// <summary>
+	/// How many words a grid's packed padding takes, which is how much room GatherNeighborPadding needs: the 4 sides plus a word for the corners
+	/// </summary>
+	size_t PaddingWordCount(Unit gridSize)
+	{
+		return EdgeWordCount(gridSize) + 1;
+	}
+
+	using HaloWords = Memory::TrackedVector<uint64_t, Memory::Subsystem::Halo>;
+
 	struct ConnectedGrid
 	{
-		ConnectedGrid(IGameBoardPtr _board) : board(std::move(_board)), north(nullptr), south(nullptr), east(nullptr), west(nullptr)
+		ConnectedGrid() : north(nullptr), east(nullptr), south(nullptr), west(nullptr), macroCoord{ 0, 0 }, tileIndex(0), awake(true),
+			changed(false), hash(0), hashDirty(false), population(0), boundsMin{ 0, 0 }, boundsMax{ 0, 0 }, paddingSwap(false),
+			paddingSettledGenerations(0)
 		{
 
 		}
@@ -15,7 +37,7 @@ namespace
 		/// <summary>
 		/// If this grid is going out, since the pointers to neighbors is bidirectional visit all alive neighbors and unhook yourself
 		/// </summary>
-		~ConnectedGrid()
+		void Unlink()
 		{
 			//Remove yourself from your northern neighbor's south link
 			if (north != nullptr)
@@ -40,6 +62,8 @@ namespace
 			{
 				west->east = nullptr;
 			}
+
+			north = south = east = west = nullptr;
 		}
 
 		ConnectedGrid* north;
@@ -47,131 +71,406 @@ namespace
 		ConnectedGrid* south;
 		ConnectedGrid* west;
 
-		const IGameBoardPtr board;
+		//Where this grid lives in the sparse grid, and where it lives in the tile table's list of grids
+		Coord macroCoord;
+		size_t tileIndex;
+
+		//Whether the grid needs stepping next generation. A grid goes to sleep when neither it nor its padding changed last generation,
+		//since then both its buffers hold the same thing and stepping it would just write that same thing again.
+		bool awake;
+
+		//Whether the generation being finished is any different from the last one, which is when everything below needs redoing
+		bool changed;
+
+		//What this grid adds to the board hash, already moved over to where the grid sits. It only needs redoing after the grid changed.
+		UnsignedUnit hash;
+		bool hashDirty;
+
+		//The sub board's population and bounding box, in its own coordinates. The box means nothing when the population is 0.
+		UnsignedUnit population;
+		Coord boundsMin;
+		Coord boundsMax;
+
+		//Our own edge cells as they are in the generation being written, packed up for our neighbors to copy out of
+		HaloWords edgeWords;
+
+		//The padding we gathered from our neighbors for the last two generations, so we can tell when it changes. Once it's been the
+		//same for two generations in a row it's the same in both our buffers, and we can stop writing it.
+		HaloWords paddingWords[2];
+		bool paddingSwap;
+		int paddingSettledGenerations;
+
+		IGameBoardPtr board;
 	};
 
 	/// <summary>
-	/// Pushes board edge cell information into neighbors' padding
+	/// Grids come and go all the time, every glider that crosses a grid border makes one and leaves one behind to be deleted. Rather than
+	/// go to the heap for every one of those, grids are carved out of slabs and handed back to a free list when they're done, sub board
+	/// and all, so once a board has warmed up it stops allocating. Grids only really get freed when the pool does.
 	/// </summary>
-	/// <param name="grid">The connected grid we will push into neighbors' padding</param>
-	/// <param name="gridSize">The size of the square grid</param>
-	void CopyBoardEdgesToNeighbors(ConnectedGrid& grid, Unit gridSize)
+	class TilePool
 	{
-		//Wanted to make padding more configurable, but doing so would require more thought for what happens in the corner regions
-		constexpr int padding = 1;
+	public:
+		TilePool(GameBoardCreationFn subBoardCreationFn) : m_subBoardCreationFn(subBoardCreationFn), m_usedInLastSlab(slabSize)
+		{
+
+		}
 
-		//Fill the bottom row of padding with the top row of this grid
-		if(grid.north != nullptr)
+		/// <summary>
+		/// Hands out a grid with an empty sub board and no neighbors. Recycled grids count as hits, grids that needed a new sub board count as misses.
+		/// </summary>
+		ConnectedGrid& Acquire(const Coord& macroCoord)
 		{
-			const Unit myY = 0;
-			const Unit theirY = gridSize;
-			for (int x = 0; x < gridSize; ++x)
+			ConnectedGrid* grid = nullptr;
+			if (!m_freeGrids.empty())
 			{
-				bool value = grid.board->GetCurrentCell(Coord{ x, myY });
-				grid.north->board->SetCell(Coord{ x, theirY }, value);
+				grid = m_freeGrids.back();
+				m_freeGrids.pop_back();
+				++m_stats.hits;
 			}
+			else
+			{
+				if (m_usedInLastSlab == slabSize)
+				{
+					m_slabs.emplace_back(slabSize);
+					m_usedInLastSlab = 0;
+				}
+				grid = &m_slabs.back()[m_usedInLastSlab++];
+				grid->board = m_subBoardCreationFn();
+				++m_stats.misses;
+
+				const Unit gridSize = grid->board->MaximumBoardLength();
+				grid->edgeWords.resize(EdgeWordCount(gridSize));
+				grid->paddingWords[0].resize(PaddingWordCount(gridSize));
+				grid->paddingWords[1].resize(PaddingWordCount(gridSize));
+			}
+
+			grid->macroCoord = macroCoord;
+			grid->awake = true;
+			grid->changed = false;
+			grid->hash = 0;
+			grid->hashDirty = false;
+			grid->population = 0;
+
+			//A new board's edges and padding are all dead, in both buffers
+			std::fill(grid->edgeWords.begin(), grid->edgeWords.end(), 0ull);
+			std::fill(grid->paddingWords[0].begin(), grid->paddingWords[0].end(), 0ull);
+			std::fill(grid->paddingWords[1].begin(), grid->paddingWords[1].end(), 0ull);
+			grid->paddingSettledGenerations = 2;
+			return *grid;
 		}
 
-		//Fill the top row of padding with the bottom row of this grid
-		if (grid.south != nullptr)
+		/// <summary>
+		/// Gives a grid back to the pool. It gets unhooked from its neighbors and its sub board gets cleared so it's ready to go for the next Acquire.
+		/// </summary>
+		void Release(ConnectedGrid& grid)
 		{
-			const Unit myY = gridSize-1;
-			const Unit theirY = -1;
-			for (int x = 0; x < gridSize; ++x)
+			grid.Unlink();
+			if (!grid.board->Empty())
 			{
-				bool value = grid.board->GetCurrentCell(Coord{ x, myY });
-				grid.south->board->SetCell(Coord{ x, theirY }, value);
+				grid.board->Clear();
 			}
+			m_freeGrids.push_back(&grid);
+		}
+
+		PoolStats Stats() const
+		{
+			return m_stats;
 		}
 
-		//Fill the left column of padding with the right column of this grid
-		if (grid.east != nullptr)
+		/// <summary>
+		/// Every grid the pool has ever made, in use or not, since none of them get freed until the pool does
+		/// </summary>
+		UnsignedUnit BytesResident() const
 		{
-			const Unit myX = gridSize - 1;
-			const Unit theirX = -1;
-			for (int y = 0; y < gridSize; ++y)
+			UnsignedUnit bytes = m_slabs.capacity() * sizeof(m_slabs[0]) + m_freeGrids.capacity() * sizeof(ConnectedGrid*);
+			for (size_t slab = 0; slab < m_slabs.size(); ++slab)
 			{
-				bool value = grid.board->GetCurrentCell(Coord{ myX, y });
-				grid.east->board->SetCell(Coord{ theirX, y }, value);
+				bytes += slabSize * sizeof(ConnectedGrid);
+
+				const size_t used = slab + 1 == m_slabs.size() ? m_usedInLastSlab : slabSize;
+				for (size_t i = 0; i < used; ++i)
+				{
+					const ConnectedGrid& grid = m_slabs[slab][i];
+					bytes += grid.board->GetBytesResident() +
+						(grid.edgeWords.capacity() + grid.paddingWords[0].capacity() + grid.paddingWords[1].capacity()) * sizeof(uint64_t);
+				}
 			}
+			return bytes;
 		}
 
-		//Fill the right column of padding with the left column of this grid
-		if (grid.west != nullptr)
+	private:
+		static constexpr size_t slabSize = 64;
+
+		GameBoardCreationFn m_subBoardCreationFn;
+		//Each slab is made at its full size and never grows, so grids never move
+		Memory::TrackedVector<Memory::TrackedVector<ConnectedGrid, Memory::Subsystem::Tiles>, Memory::Subsystem::Tiles> m_slabs;
+		size_t m_usedInLastSlab;
+		Memory::TrackedVector<ConnectedGrid*, Memory::Subsystem::Tiles> m_freeGrids;
+		PoolStats m_stats;
+	};
+
+	/// <summary>
+	/// Maps macro coordinates to the grids living there. The lookup side is a flat open addressing hash table with linear probing,
+	/// where each slot holds the coordinate right next to the grid pointer so probing never has to leave the slot array. The grids
+	/// themselves sit in a plain list so that walking every grid is a walk over an array, and so that they never move when the hash
+	/// table grows, since neighbors hold pointers to each other.
+	/// Neither side keeps any particular order, so anyone who needs one has to sort.
+	/// </summary>
+	class TileTable
+	{
+	public:
+		TileTable(GameBoardCreationFn subBoardCreationFn) : m_pool(subBoardCreationFn)
 		{
-			const Unit myX = 0;
-			const Unit theirX = gridSize;
-			for (int y = 0; y < gridSize; ++y)
+			Clear();
+		}
+
+		~TileTable()
+		{
+			Clear();
+		}
+
+		void Clear()
+		{
+			for (ConnectedGrid* grid : m_grids)
 			{
-				bool value = grid.board->GetCurrentCell(Coord{ myX, y });
-				grid.west->board->SetCell(Coord{ theirX, y }, value);
+				m_pool.Release(*grid);
 			}
+			m_grids.clear();
+			m_slots.assign(minimumSlotCount, Slot{ Coord{ 0, 0 }, nullptr });
 		}
 
-		//grab northwest corner and put in southeast
-		if (grid.west != nullptr && grid.north != nullptr)
+		PoolStats Stats() const
 		{
-			ConnectedGrid* northWest = grid.north->west == nullptr ? grid.west->north : grid.north->west;
-			
-			if (northWest != nullptr)
-			{
-				//While we're here, do a debug sanity check to make sure we did indeed hook everything up properly.
-				assert(grid.north->west == nullptr || grid.west->north == nullptr || 
-					(grid.north->west == northWest && grid.west->north == northWest));
+			return m_pool.Stats();
+		}
 
+		UnsignedUnit BytesResident() const
+		{
+			return m_pool.BytesResident() + m_slots.capacity() * sizeof(Slot) + m_grids.capacity() * sizeof(ConnectedGrid*);
+		}
+
+		bool Empty() const
+		{
+			return m_grids.empty();
+		}
 
-				bool value = grid.board->GetCurrentCell(Coord{ 0, 0 });
-				northWest->board->SetCell(Coord{ gridSize, gridSize }, value);
+		size_t Size() const
+		{
+			return m_grids.size();
+		}
+
+		/// <summary>
+		/// The grid at a macro coordinate, or nullptr if there isn't one
+		/// </summary>
+		ConnectedGrid* Find(const Coord& macroCoord) const
+		{
+			const size_t mask = m_slots.size() - 1;
+			for (size_t slot = HashCoord()(macroCoord) & mask; ; slot = (slot + 1) & mask)
+			{
+				if (m_slots[slot].grid == nullptr)
+				{
+					return nullptr;
+				}
+				if (EqualCoord()(m_slots[slot].macroCoord, macroCoord))
+				{
+					return m_slots[slot].grid;
+				}
 			}
 		}
 
-		//grab northeast corner and put in southwest
-		if (grid.east != nullptr && grid.north != nullptr)
+		/// <summary>
+		/// Finds the grid at a macro coordinate, taking one from the pool if there isn't one yet
+		/// </summary>
+		ConnectedGrid& FindOrCreate(const Coord& macroCoord)
 		{
-			ConnectedGrid* northEast = grid.north->east == nullptr ? grid.east->north : grid.north->east;
+			if (ConnectedGrid* found = Find(macroCoord))
+			{
+				return *found;
+			}
 
-			if (northEast != nullptr)
+			Instrumentation::ScopedPhase createTimer(Instrumentation::Phase::TileCreate);
+
+			//Keep the table at most half full so probe runs stay short
+			if ((m_grids.size() + 1) * 2 > m_slots.size())
 			{
-				//While we're here, do a debug sanity check to make sure we did indeed hook everything up properly.
-				assert(grid.north->east == nullptr || grid.east->north == nullptr ||
-					(grid.north->east == northEast && grid.east->north == northEast));
+				Rehash(m_slots.size() * 2);
+			}
+
+			ConnectedGrid* grid = m_grids.emplace_back(&m_pool.Acquire(macroCoord));
+			grid->tileIndex = m_grids.size() - 1;
+			InsertSlot(Slot{ macroCoord, grid });
 
-				bool value = grid.board->GetCurrentCell(Coord{ gridSize - 1, 0 });
-				northEast->board->SetCell(Coord{ -1, gridSize }, value);
+			//Link up with whoever is already around us. Keeping the links complete means a link is only ever null when there's no
+			//grid there, which lets the padding copy find diagonal neighbors by walking links instead of going back to the table.
+			if ((grid->north = Find(Coord{ macroCoord.x, macroCoord.y - 1 })) != nullptr)
+			{
+				grid->north->south = grid;
+			}
+			if ((grid->south = Find(Coord{ macroCoord.x, macroCoord.y + 1 })) != nullptr)
+			{
+				grid->south->north = grid;
 			}
+			if ((grid->east = Find(Coord{ macroCoord.x + 1, macroCoord.y })) != nullptr)
+			{
+				grid->east->west = grid;
+			}
+			if ((grid->west = Find(Coord{ macroCoord.x - 1, macroCoord.y })) != nullptr)
+			{
+				grid->west->east = grid;
+			}
+			return *grid;
 		}
 
-		//grab southeast corner and put in northwest
-		if (grid.east != nullptr && grid.south != nullptr)
+		/// <summary>
+		/// Removes a grid. The last grid in the list takes its place, so when erasing while walking the list by index, don't move on
+		/// to the next index afterwards.
+		/// </summary>
+		void Erase(ConnectedGrid& grid)
 		{
-			ConnectedGrid* southEast = grid.south->east == nullptr ? grid.east->south : grid.south->east;
+			Instrumentation::ScopedPhase eraseTimer(Instrumentation::Phase::TileErase);
+			EraseSlot(grid.macroCoord);
 
-			if (southEast != nullptr)
+			const size_t tileIndex = grid.tileIndex;
+			if (tileIndex + 1 != m_grids.size())
 			{
-				//While we're here, do a debug sanity check to make sure we did indeed hook everything up properly.
-				assert(grid.south->east == nullptr || grid.east->south == nullptr ||
-					(grid.south->east == southEast && grid.east->south == southEast));
+				m_grids[tileIndex] = m_grids.back();
+				m_grids[tileIndex]->tileIndex = tileIndex;
+			}
+			m_grids.pop_back();
+
+			m_pool.Release(grid);
+		}
+
+		ConnectedGrid& operator[](size_t tileIndex) const
+		{
+			return *m_grids[tileIndex];
+		}
 
-				bool value = grid.board->GetCurrentCell(Coord{ gridSize - 1, gridSize - 1 });
-				southEast->board->SetCell(Coord{ -1, -1 }, value);
+		/// <summary>
+		/// All the grids, sorted by their macro coordinate a row at a time. This is the order the tiles used to be stored in, so it's
+		/// what anyone who needs stable output should walk.
+		/// </summary>
+		std::vector<const ConnectedGrid*> SortedGrids() const
+		{
+			std::vector<const ConnectedGrid*> sortedGrids(m_grids.begin(), m_grids.end());
+
+			std::sort(sortedGrids.begin(), sortedGrids.end(), [](const ConnectedGrid* lhs, const ConnectedGrid* rhs)
+				{
+					return LessCoord()(lhs->macroCoord, rhs->macroCoord);
+				});
+			return sortedGrids;
+		}
+
+	private:
+		struct Slot
+		{
+			Coord macroCoord;
+			ConnectedGrid* grid;
+		};
+
+		static constexpr size_t minimumSlotCount = 64;
+
+		void InsertSlot(const Slot& newSlot)
+		{
+			const size_t mask = m_slots.size() - 1;
+			size_t slot = HashCoord()(newSlot.macroCoord) & mask;
+			while (m_slots[slot].grid != nullptr)
+			{
+				slot = (slot + 1) & mask;
 			}
+			m_slots[slot] = newSlot;
 		}
 
-		//grab southwest corner and put in northeast
-		if (grid.west != nullptr && grid.south != nullptr)
+		/// <summary>
+		/// Linear probing lets us delete without leaving tombstones behind. After emptying a slot, walk the rest of the probe run and
+		/// pull back any entry that would no longer be reachable from its home slot.
+		/// </summary>
+		void EraseSlot(const Coord& macroCoord)
 		{
-			ConnectedGrid* southWest = grid.south->west == nullptr ? grid.west->south : grid.south->west;
+			const size_t mask = m_slots.size() - 1;
+			size_t hole = HashCoord()(macroCoord) & mask;
+			while (!EqualCoord()(m_slots[hole].macroCoord, macroCoord) || m_slots[hole].grid == nullptr)
+			{
+				assert(m_slots[hole].grid != nullptr);
+				hole = (hole + 1) & mask;
+			}
 
-			if (southWest != nullptr)
+			for (size_t slot = (hole + 1) & mask; m_slots[slot].grid != nullptr; slot = (slot + 1) & mask)
 			{
-				//While we're here, do a debug sanity check to make sure we did indeed hook everything up properly.
-				assert(grid.south->west == nullptr || grid.west->south == nullptr ||
-					(grid.south->west == southWest && grid.west->south == southWest));
+				const size_t home = HashCoord()(m_slots[slot].macroCoord) & mask;
+
+				//The entry can move to the hole if its home is not in the (cyclic) range between the hole and where it is now
+				const bool homeBetweenHoleAndSlot = hole <= slot ? (home > hole && home <= slot) : (home > hole || home <= slot);
+				if (!homeBetweenHoleAndSlot)
+				{
+					m_slots[hole] = m_slots[slot];
+					hole = slot;
+				}
+			}
+
+			m_slots[hole].grid = nullptr;
+		}
 
-				bool value = grid.board->GetCurrentCell(Coord{ 0, gridSize - 1 });
-				southWest->board->SetCell(Coord{ gridSize, -1 }, value);
+		void Rehash(size_t slotCount)
+		{
+			m_slots.assign(slotCount, Slot{ Coord{ 0, 0 }, nullptr });
+			for (ConnectedGrid* grid : m_grids)
+			{
+				InsertSlot(Slot{ grid->macroCoord, grid });
 			}
 		}
+
+		//The pool has to outlive the grids it handed out
+		TilePool m_pool;
+		Memory::TrackedVector<Slot, Memory::Subsystem::NeighborLinks> m_slots;
+		Memory::TrackedVector<ConnectedGrid*, Memory::Subsystem::Tiles> m_grids;
+	};
+
+	/// <summary>
+	/// Puts together this grid's padding out of the edges the grids around it packed up, in the layout SetPaddingCells wants. Each side is
+	/// a straight copy of words, no sub board gets asked anything. Dead cells get recorded where there's no neighbor, so nothing stale can
+	/// be left behind by a neighbor that got deleted.
+	/// </summary>
+	/// <param name="grid">The connected grid whose padding we will fill</param>
+	/// <param name="gridSize">The size of the square grid</param>
+	/// <param name="padding">Where to put the cells, PaddingWordCount long</param>
+	void GatherNeighborPadding(const ConnectedGrid& grid, Unit gridSize, uint64_t* padding)
+	{
+		const size_t words = EdgeWords(gridSize);
+		enum EdgeSide { top, bottom, left, right };
+		auto copySide = [words](const ConnectedGrid* neighbor, EdgeSide side, uint64_t* destination)
+		{
+			if (neighbor != nullptr)
+			{
+				std::copy_n(neighbor->edgeWords.data() + side * words, words, destination);
+			}
+			else
+			{
+				std::fill_n(destination, words, 0ull);
+			}
+		};
+
+		//The top row of padding comes from the bottom row of the grid to the north, and so on around
+		copySide(grid.north, bottom, padding);
+		copySide(grid.south, top, padding + words);
+		copySide(grid.west, right, padding + 2 * words);
+		copySide(grid.east, left, padding + 3 * words);
+
+		//The corners come from the diagonal neighbors, which we reach through either of the grids between us. There's a case where a
+		//diagonal neighbor exists but neither of those do, but then it has to be empty, since any grid with cells gets hooked up to all
+		//its neighbors before we get here, so it has nothing to give us anyway.
+		const ConnectedGrid* northWest = grid.north != nullptr ? grid.north->west : (grid.west != nullptr ? grid.west->north : nullptr);
+		const ConnectedGrid* northEast = grid.north != nullptr ? grid.north->east : (grid.east != nullptr ? grid.east->north : nullptr);
+		const ConnectedGrid* southWest = grid.south != nullptr ? grid.south->west : (grid.west != nullptr ? grid.west->south : nullptr);
+		const ConnectedGrid* southEast = grid.south != nullptr ? grid.south->east : (grid.east != nullptr ? grid.east->south : nullptr);
+
+		auto corner = [words, gridSize](const ConnectedGrid* neighbor, EdgeSide side, Unit cell) -> uint64_t
+		{
+			return neighbor != nullptr ? ReadRowBits(neighbor->edgeWords.data() + side * words, cell, 1) : 0;
+		};
+		padding[4 * words] = corner(northWest, bottom, gridSize - 1) | corner(northEast, bottom, 0) << 1 |
+			corner(southWest, top, gridSize - 1) << 2 | corner(southEast, top, 0) << 3;
 	}
 
 	std::pair<Coord, Coord> GetMacroAndLocalCoordFromParentCoord(const Coord& position, Unit gridSize)
@@ -195,9 +494,14 @@ namespace
 	class MultiGridBoard : public IGameBoard
 	{
 	public:
-		MultiGridBoard(GameBoardCreationFn subBoardCreationFn):
+		MultiGridBoard(GameBoardCreationFn subBoardCreationFn, unsigned workerCount):
 			m_subBoardCreationFn(subBoardCreationFn),
-			m_gridSize(subBoardCreationFn !=nullptr ? subBoardCreationFn()->MaximumBoardLength() : 0) // To get the grid size, just make one of the sub boards and ask it
+			m_gridSize(subBoardCreationFn !=nullptr ? subBoardCreationFn()->MaximumBoardLength() : 0), // To get the grid size, just make one of the sub boards and ask it
+			m_connectedGrids(subBoardCreationFn),
+			m_hash(0),
+			m_population(0),
+			m_boundsMin{ 0, 0 },
+			m_boundsMax{ 0, 0 }
 		{
 			if (m_subBoardCreationFn == nullptr)
 			{
@@ -206,6 +510,11 @@ namespace
 				std::cout << "MultiGridBoard was not passed a sub board creation function! This board is invalid";
 			}
 
+			if (workerCount != 1)
+			{
+				m_threadPool = std::make_unique<ThreadPool>(workerCount);
+			}
+
 			Clear();
 		}
 
@@ -214,7 +523,9 @@ namespace
 		/// </summary>
 		void Clear()
 		{
-			m_connectedGrids.clear();
+			m_connectedGrids.Clear();
+			m_hash = 0;
+			m_population = 0;
 		}
 
 		/// <summary>
@@ -223,21 +534,19 @@ namespace
 		/// <returns></returns>
 		bool Empty()
 		{
-			return m_connectedGrids.empty();
+			return m_connectedGrids.Empty();
 		}
 
 		/// <summary>
 		/// Find the sub-board and call it's get cell. If we can't find the board we can safely assume it is a dead cell.
-		/// This is expensive since we need to traverse the map every time.
 		/// </summary>
 		bool GetCell(const Coord& position) const
 		{
 			auto [macroCoord, localCoord] = GetMacroAndLocalCoordFromParentCoord(position, m_gridSize);
 
-			auto foundGrid = m_connectedGrids.find(macroCoord);
-			if (foundGrid != m_connectedGrids.end())
+			if (const ConnectedGrid* foundGrid = m_connectedGrids.Find(macroCoord))
 			{
-				return foundGrid->second.board->GetCell(localCoord);
+				return foundGrid->board->GetCell(localCoord);
 			}
 
 			return false;
@@ -245,16 +554,14 @@ namespace
 
 		/// <summary>
 		/// Find the sub-board and call it's get cell. If we can't find the board we can safely assume it is a dead cell.
-		/// This is expensive since we need to traverse the map every time.
 		/// </summary>
 		bool GetCurrentCell(const Coord& position) const
 		{
 			auto [macroCoord, localCoord] = GetMacroAndLocalCoordFromParentCoord(position, m_gridSize);
 
-			auto foundGrid = m_connectedGrids.find(macroCoord);
-			if (foundGrid != m_connectedGrids.end())
+			if (const ConnectedGrid* foundGrid = m_connectedGrids.Find(macroCoord))
 			{
-				return foundGrid->second.board->GetCurrentCell(localCoord);
+				return foundGrid->board->GetCurrentCell(localCoord);
 			}
 
 			return false;
@@ -262,17 +569,18 @@ namespace
 
 		/// <summary>
 		/// Find the sub-board and call it's set cell. If you're setting the cell to dead and we can't find a board, it's a no-op
-		/// If you need to set a cell to alive and we don't have a board for it, create it. This is expensive since we need to traverse
-		/// the map every time.
+		/// If you need to set a cell to alive and we don't have a board for it, create it.
 		/// </summary>
 		void SetCell(const Coord& position, bool value)
 		{
 			auto [macroCoord, localCoord] = GetMacroAndLocalCoordFromParentCoord(position, m_gridSize);
 
-			auto foundGrid = m_connectedGrids.find(macroCoord);
-			if (foundGrid != m_connectedGrids.end())
+			if (ConnectedGrid* foundGrid = m_connectedGrids.Find(macroCoord))
 			{
-				foundGrid->second.board->SetCell(localCoord, value);
+				foundGrid->board->SetCell(localCoord, value);
+
+				//Somebody poked this grid from outside, so it can't stay asleep
+				foundGrid->awake = true;
 			}
 			else if (value == true && m_subBoardCreationFn != nullptr)
 			{
@@ -281,6 +589,106 @@ namespace
 			}
 		}
 
+		/// <summary>
+		/// Cells that land in the same grid one after another get handed over together, so each of those runs only needs one lookup and
+		/// one call into the grid, and while a run lasts its cells are found with a bounds check instead of a division. Batches from a
+		/// loader or a test tend to come a row or a line at a time, which keeps the runs going without having to sort anything. Sorting or
+		/// bucketing the batch by grid first made the runs longer, but cost more than the lookups it saved.
+		/// </summary>
+		void SetCells(std::span<const Coord> cells, bool value)
+		{
+			if (m_subBoardCreationFn == nullptr || cells.empty())
+			{
+				return;
+			}
+
+			m_localCells.clear();
+			Coord runMacroCoord = GetMacroAndLocalCoordFromParentCoord(cells.front(), m_gridSize).first;
+			Coord runOrigin{ runMacroCoord.x * m_gridSize, runMacroCoord.y * m_gridSize };
+			for (const Coord& cell : cells)
+			{
+				//Unsigned so anything left of or above the grid wraps around to a big number and fails the check too
+				const UnsignedUnit localX = static_cast<UnsignedUnit>(cell.x) - static_cast<UnsignedUnit>(runOrigin.x);
+				const UnsignedUnit localY = static_cast<UnsignedUnit>(cell.y) - static_cast<UnsignedUnit>(runOrigin.y);
+				Coord localCoord{ static_cast<Unit>(localX), static_cast<Unit>(localY) };
+				if (localX >= static_cast<UnsignedUnit>(m_gridSize) || localY >= static_cast<UnsignedUnit>(m_gridSize))
+				{
+					SetGridCells(runMacroCoord, value);
+
+					auto [macroCoord, gridLocalCoord] = GetMacroAndLocalCoordFromParentCoord(cell, m_gridSize);
+					runMacroCoord = macroCoord;
+					localCoord = gridLocalCoord;
+					runOrigin = Coord{ runMacroCoord.x * m_gridSize, runMacroCoord.y * m_gridSize };
+				}
+				m_localCells.push_back(localCoord);
+			}
+			SetGridCells(runMacroCoord, value);
+		}
+
+		/// <summary>
+		/// Splits the run where it crosses from one grid into the next, so each grid only gets looked up once
+		/// </summary>
+		void SetCellRun(const Coord& start, Unit length, bool value)
+		{
+			Coord position = start;
+			while (length > 0)
+			{
+				auto [macroCoord, localCoord] = GetMacroAndLocalCoordFromParentCoord(position, m_gridSize);
+				const Unit gridLength = std::min(length, m_gridSize - localCoord.x);
+
+				if (ConnectedGrid* foundGrid = m_connectedGrids.Find(macroCoord))
+				{
+					foundGrid->board->SetCellRun(localCoord, gridLength, value);
+					foundGrid->awake = true;
+				}
+				else if (value == true && m_subBoardCreationFn != nullptr)
+				{
+					CreateAndHookUpBoard(macroCoord).board->SetCellRun(localCoord, gridLength, value);
+				}
+
+				position.x += gridLength;
+				length -= gridLength;
+			}
+		}
+
+		/// <summary>
+		/// Splits the row at grid boundaries the same way SetCellRun does. A piece that doesn't start on a word boundary gets shifted
+		/// into a scratch row first, since the grids want their piece starting at bit 0. Restoring a snapshot into a board with the same
+		/// grid size lines every piece up with a whole grid, so that never happens there.
+		/// </summary>
+		void SetCellRow(const Coord& start, Unit length, const uint64_t* bits)
+		{
+			Unit offset = 0;
+			while (offset < length)
+			{
+				auto [macroCoord, localCoord] = GetMacroAndLocalCoordFromParentCoord(Coord{ start.x + offset, start.y }, m_gridSize);
+				const Unit gridLength = std::min(length - offset, m_gridSize - localCoord.x);
+
+				const uint64_t* gridBits = bits + offset / 64;
+				if (offset % 64 != 0)
+				{
+					m_rowScratch.resize((gridLength + 63) / 64);
+					for (Unit cell = 0; cell < gridLength; cell += 64)
+					{
+						m_rowScratch[cell / 64] = ReadRowBits(bits, offset + cell, static_cast<int>(std::min<Unit>(gridLength - cell, 64)));
+					}
+					gridBits = m_rowScratch.data();
+				}
+
+				if (ConnectedGrid* foundGrid = m_connectedGrids.Find(macroCoord))
+				{
+					foundGrid->board->SetCellRow(localCoord, gridLength, gridBits);
+					foundGrid->awake = true;
+				}
+				else if (m_subBoardCreationFn != nullptr && AnyCellAlive(gridBits, gridLength))
+				{
+					CreateAndHookUpBoard(macroCoord).board->SetCellRow(localCoord, gridLength, gridBits);
+				}
+
+				offset += gridLength;
+			}
+		}
+
 		/// <summary>
 		/// We should support any grid location in the 64 bit space
 		/// </summary>
@@ -292,137 +700,457 @@ namespace
 
 		/// <summary>
 		/// Performs the intrusive operations to clean up boards that are far away from live cells and copy cell locations from adjacent boards
-		/// to padding
+		/// to padding. The grids aren't kept in any order, so this is done in passes: first settle which grids exist, then fill everyone's
+		/// padding, so that nothing depends on which grid happened to be visited first.
 		/// </summary>
 		void FinishCurrentGeneration()
 		{
-			auto gridIt = m_connectedGrids.begin();
-			while (gridIt != m_connectedGrids.end())
+			size_t tileIndex = 0;
+			while (tileIndex < m_connectedGrids.Size())
 			{
-				bool isEmpty = gridIt->second.board->Empty();
+				ConnectedGrid& grid = m_connectedGrids[tileIndex];
+				bool isEmpty = grid.board->Empty();
 
 				//Delete boards which have no cells on them after the generation ends, and have no neighboring grids with cells in them either
 				if (isEmpty &&
-					(gridIt->second.north == nullptr || gridIt->second.north->board->Empty()) &&
-					(gridIt->second.south == nullptr || gridIt->second.south->board->Empty()) &&
-					(gridIt->second.east == nullptr || gridIt->second.east->board->Empty()) &&
-					(gridIt->second.west == nullptr || gridIt->second.west->board->Empty()))
+					(grid.north == nullptr || grid.north->board->Empty()) &&
+					(grid.south == nullptr || grid.south->board->Empty()) &&
+					(grid.east == nullptr || grid.east->board->Empty()) &&
+					(grid.west == nullptr || grid.west->board->Empty()))
 				{
-					gridIt = m_connectedGrids.erase(gridIt);
+					//The last grid gets moved into this spot, so look at this index again
+					m_hash -= grid.hash;
+					m_connectedGrids.Erase(grid);
 				}
 				else
 				{
 					//If this board isn't empty, then make sure it has neighbors
 					if (!isEmpty)
 					{
-						HookUpBoard(gridIt->first, gridIt->second);
+						HookUpBoard(grid);
 					}
-					CopyBoardEdgesToNeighbors(gridIt->second, m_gridSize);
-					++gridIt;
+					++tileIndex;
 				}
 			}
 
-			gridIt = m_connectedGrids.begin();
-			while (gridIt != m_connectedGrids.end())
+			//Now that every grid that should exist does, fill everyone's padding. Every grid packs up its own edges first, then
+			//copies its padding out of its neighbors' edges, and only then does anyone write, so nobody reads a half written grid.
+			//This is also where we work out who needs stepping next generation: a grid stays awake if it changed, or if the edges
+			//around it did. A sleeping grid wasn't stepped so it can't have changed, no need to ask it, and a grid that didn't change
+			//still has the same edges it packed up last time.
+			Instrumentation::ScopedPhase haloTimer(Instrumentation::Phase::Halo);
+			ForEachGrid([this](ConnectedGrid& grid)
+				{
+					grid.awake = grid.awake && grid.board->CurrentGenerationChanged();
+					grid.changed = grid.awake;
+					if (grid.awake)
+					{
+						grid.hashDirty = true;
+						grid.board->GetCurrentEdgeCells(m_gridSize, grid.edgeWords.data());
+					}
+				});
+
+			ForEachGrid([this](ConnectedGrid& grid)
+				{
+					HaloWords& padding = grid.paddingWords[!grid.paddingSwap];
+					GatherNeighborPadding(grid, m_gridSize, padding.data());
+					if (padding == grid.paddingWords[grid.paddingSwap])
+					{
+						grid.paddingSettledGenerations = std::min(grid.paddingSettledGenerations + 1, 2);
+					}
+					else
+					{
+						grid.paddingSettledGenerations = 0;
+						grid.awake = true;
+					}
+				});
+
+			ForEachGrid([this](ConnectedGrid& grid)
+				{
+					//The back buffer's padding is from two generations ago, so it only needs writing if that's different from now
+					grid.paddingSwap = !grid.paddingSwap;
+					if (grid.paddingSettledGenerations < 2)
+					{
+						grid.board->SetPaddingCells(m_gridSize, grid.paddingWords[grid.paddingSwap].data());
+					}
+					grid.board->FinishCurrentGeneration();
+
+					if (grid.changed)
+					{
+						grid.population = grid.board->GetPopulation();
+						grid.board->GetBoundingBox(grid.boundsMin, grid.boundsMax);
+					}
+				});
+
+			AddUpPopulationAndBounds();
+		}
+
+		/// <summary>
+		/// How well the grid pool is keeping up. Misses should stop growing once the board has warmed up.
+		/// </summary>
+		PoolStats GetPoolStats() const
+		{
+			return m_connectedGrids.Stats();
+		}
+
+		UnsignedUnit GetBytesResident() const
+		{
+			return sizeof(*this) + m_connectedGrids.BytesResident() + m_rowScratch.capacity() * sizeof(uint64_t) + m_localCells.capacity() * sizeof(Coord);
+		}
+
+		/// <summary>
+		/// Both of these were added up from every grid's own at the end of the generation
+		/// </summary>
+		UnsignedUnit GetPopulation() const
+		{
+			return m_population;
+		}
+
+		bool GetBoundingBox(Coord& min, Coord& max) const
+		{
+			if (m_population == 0)
 			{
-				//Stores if the board was empty before finalizing the current generation, so we can check
-				//if this grid was empty and now is no longer empty
-				//bool wasEmpty = gridIt->second.board->Empty();
+				return false;
+			}
 
-				gridIt->second.board->FinishCurrentGeneration();
-				++gridIt;
+			min = m_boundsMin;
+			max = m_boundsMax;
+			return true;
+		}
+
+		/// <summary>
+		/// Keeps a running total of every grid's hash and only redoes the grids that changed since the last time we were asked, so a
+		/// board that's mostly still costs about as much as the part of it that's moving.
+		/// </summary>
+		UnsignedUnit GetBoardHash() const
+		{
+			for (size_t tileIndex = 0; tileIndex < m_connectedGrids.Size(); ++tileIndex)
+			{
+				ConnectedGrid& grid = m_connectedGrids[tileIndex];
+				if (grid.hashDirty)
+				{
+					m_hash -= grid.hash;
+					grid.hash = TranslateBoardHash(grid.board->GetBoardHash(), Coord{ grid.macroCoord.x * m_gridSize, grid.macroCoord.y * m_gridSize });
+					m_hash += grid.hash;
+					grid.hashDirty = false;
+				}
 			}
+			return m_hash;
 		}
 
 		/// <summary>
 		/// This one just walks the grid and looks at itself and the adjacent cells
 		/// </summary>
-		void IterateCurrentGenerationBoard(GameSimFn gameSim)
+		void IterateCurrentGenerationBoard(const RuleMasks& rule)
+		{
+			//Each grid only reads its own front buffer and padding, and only writes its own back buffer, so they can all go at once.
+			//Sleeping grids already have this generation sitting in their back buffer.
+			ForEachGrid([&rule](ConnectedGrid& grid)
+				{
+					if (grid.awake && !grid.board->Empty())
+					{
+						grid.board->IterateCurrentGenerationBoard(rule);
+					}
+				});
+		}
+
+		/// <summary>
+		/// Walk all the connected grids in row order and print them out, so the output doesn't depend on how the table is laid out
+		/// </summary>
+		void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const
 		{
-			for (auto& grid : m_connectedGrids)
+			for (const ConnectedGrid* grid : m_connectedGrids.SortedGrids())
 			{
-				if (!grid.second.board->Empty())
+				if (!grid->board->Empty())
 				{
-					grid.second.board->IterateCurrentGenerationBoard(gameSim);
+					Coord aliveCellCoord = {	grid->macroCoord.x * m_gridSize + parentCoord.x,
+												grid->macroCoord.y * m_gridSize + parentCoord.y };
+					grid->board->IterateCurrentGenerationAliveCells(aliveCellCoord, fn);
 				}
 			}
 		}
 
 		/// <summary>
-		/// Walk all the connected grids and print them out
+		/// Same order as above, but every grid pushes into the one block, so the std::function that used to get called for each cell
+		/// of each grid only gets called once per block
 		/// </summary>
-		void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const
+		void CollectCurrentGenerationAliveCells(const Coord& parentCoord, AliveCellBlock& block) const
+		{
+			for (const ConnectedGrid* grid : m_connectedGrids.SortedGrids())
+			{
+				if (!grid->board->Empty())
+				{
+					Coord aliveCellCoord = {	grid->macroCoord.x * m_gridSize + parentCoord.x,
+												grid->macroCoord.y * m_gridSize + parentCoord.y };
+					grid->board->CollectCurrentGenerationAliveCells(aliveCellCoord, block);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Grids in the same row of the table cover the same rows of cells, so once each grid's cells are in order, a row of grids can be
+		/// put in order by taking the first row of cells from each grid left to right, then the second row, and so on. Rows of grids don't
+		/// overlap at all, so they each get done on their own thread and then stacked on top of each other.
+		/// </summary>
+		void GetSortedAliveCells(std::vector<Coord>& cells) const
 		{
-			for (auto& grid : m_connectedGrids)
+			std::vector<const ConnectedGrid*> sortedGrids = m_connectedGrids.SortedGrids();
+			sortedGrids.erase(std::remove_if(sortedGrids.begin(), sortedGrids.end(), [](const ConnectedGrid* grid) { return grid->board->Empty(); }),
+				sortedGrids.end());
+
+			//Where each row of grids starts in sortedGrids
+			std::vector<size_t> bandStarts;
+			for (size_t gridIndex = 0; gridIndex < sortedGrids.size(); ++gridIndex)
 			{
-				if (!grid.second.board->Empty())
+				if (gridIndex == 0 || sortedGrids[gridIndex]->macroCoord.y != sortedGrids[gridIndex - 1]->macroCoord.y)
 				{
-					Coord aliveCellCoord = {	grid.first.x * m_gridSize + parentCoord.x,
-												grid.first.y * m_gridSize + parentCoord.y };
-					grid.second.board->IterateCurrentGenerationAliveCells(aliveCellCoord, fn);
+					bandStarts.push_back(gridIndex);
 				}
 			}
+			bandStarts.push_back(sortedGrids.size());
+
+			const size_t bandCount = bandStarts.size() - 1;
+			std::vector<std::vector<Coord>> bandCells(bandCount);
+			ParallelFor(bandCount, 1, [this, &sortedGrids, &bandStarts, &bandCells](size_t begin, size_t end)
+				{
+					std::vector<std::vector<Coord>> gridCells;
+					for (size_t band = begin; band < end; ++band)
+					{
+						const size_t bandStart = bandStarts[band];
+						const size_t bandGridCount = bandStarts[band + 1] - bandStart;
+
+						gridCells.resize(bandGridCount);
+						size_t bandCellCount = 0;
+						for (size_t gridIndex = 0; gridIndex < bandGridCount; ++gridIndex)
+						{
+							const ConnectedGrid& grid = *sortedGrids[bandStart + gridIndex];
+							grid.board->GetSortedAliveCells(gridCells[gridIndex]);
+							bandCellCount += gridCells[gridIndex].size();
+						}
+
+						//Deal out the grids' cells a row at a time. Each grid is sorted, so its next row is always at the front of what's left.
+						std::vector<Coord>& sortedCells = bandCells[band];
+						sortedCells.reserve(bandCellCount);
+						std::vector<size_t> nextCell(bandGridCount, 0);
+						const Unit bandY = sortedGrids[bandStart]->macroCoord.y * m_gridSize;
+						for (Unit row = 0; row < m_gridSize; ++row)
+						{
+							for (size_t gridIndex = 0; gridIndex < bandGridCount; ++gridIndex)
+							{
+								const std::vector<Coord>& localCells = gridCells[gridIndex];
+								const Unit gridX = sortedGrids[bandStart + gridIndex]->macroCoord.x * m_gridSize;
+								size_t& cellIndex = nextCell[gridIndex];
+								for (; cellIndex < localCells.size() && localCells[cellIndex].y == row; ++cellIndex)
+								{
+									sortedCells.push_back(Coord{ localCells[cellIndex].x + gridX, row + bandY });
+								}
+							}
+						}
+					}
+				});
+
+			size_t cellCount = 0;
+			std::vector<size_t> bandOffsets(bandCount);
+			for (size_t band = 0; band < bandCount; ++band)
+			{
+				bandOffsets[band] = cellCount;
+				cellCount += bandCells[band].size();
+			}
+
+			cells.resize(cellCount);
+			ParallelFor(bandCount, 1, [&cells, &bandCells, &bandOffsets](size_t begin, size_t end)
+				{
+					for (size_t band = begin; band < end; ++band)
+					{
+						std::copy(bandCells[band].begin(), bandCells[band].end(), cells.begin() + bandOffsets[band]);
+					}
+				});
+		}
+
+		/// <summary>
+		/// Hands out the grids in row order so snapshots of the same board always come out the same
+		/// </summary>
+		bool IterateTiles(TileIteratorFn fn) const
+		{
+			for (const ConnectedGrid* grid : m_connectedGrids.SortedGrids())
+			{
+				if (!grid->board->Empty())
+				{
+					fn(Coord{ grid->macroCoord.x * m_gridSize, grid->macroCoord.y * m_gridSize }, m_gridSize, *grid->board);
+				}
+			}
+			return true;
 		}
 
 	private:
+		/// <summary>
+		/// The grids that changed worked out their own population and bounds while they were being finished, on whichever thread had
+		/// them, so all that's left is a quick pass over the grids to add those up
+		/// </summary>
+		void AddUpPopulationAndBounds()
+		{
+			m_population = 0;
+			BoundsBuilder bounds;
+			for (size_t tileIndex = 0; tileIndex < m_connectedGrids.Size(); ++tileIndex)
+			{
+				const ConnectedGrid& grid = m_connectedGrids[tileIndex];
+				if (grid.population != 0)
+				{
+					const Coord offset{ grid.macroCoord.x * m_gridSize, grid.macroCoord.y * m_gridSize };
+					m_population += grid.population;
+					bounds.Add(Coord{ grid.boundsMin.x + offset.x, grid.boundsMin.y + offset.y }, Coord{ grid.boundsMax.x + offset.x, grid.boundsMax.y + offset.y });
+				}
+			}
+			bounds.Get(m_boundsMin, m_boundsMax);
+		}
+
+		/// <summary>
+		/// Hands the run of cells SetCells has been collecting to the grid they belong to, making the grid if they're alive and it isn't
+		/// there yet
+		/// </summary>
+		void SetGridCells(const Coord& macroCoord, bool value)
+		{
+			if (m_localCells.empty())
+			{
+				return;
+			}
+
+			if (ConnectedGrid* foundGrid = m_connectedGrids.Find(macroCoord))
+			{
+				foundGrid->board->SetCells(m_localCells, value);
+				foundGrid->awake = true;
+			}
+			else if (value == true)
+			{
+				CreateAndHookUpBoard(macroCoord).board->SetCells(m_localCells, value);
+			}
+			m_localCells.clear();
+		}
+
+		/// <summary>
+		/// If any of the first length cells in a packed row are set
+		/// </summary>
+		static bool AnyCellAlive(const uint64_t* bits, Unit length)
+		{
+			for (Unit cell = 0; cell < length; cell += 64)
+			{
+				if (ReadRowBits(bits, cell, static_cast<int>(std::min<Unit>(length - cell, 64))) != 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// <summary>
+		/// Runs fn on every grid, spread over the thread pool if we have one. fn can only touch the grid it's given.
+		/// </summary>
+		template<class GridFn>
+		void ForEachGrid(const GridFn& fn)
+		{
+			//Small grids are only a handful of instructions each, so hand them out in batches
+			constexpr size_t gridsPerRange = 64;
+			ParallelFor(m_connectedGrids.Size(), gridsPerRange, [this, &fn](size_t begin, size_t end)
+				{
+					for (size_t tileIndex = begin; tileIndex < end; ++tileIndex)
+					{
+						fn(m_connectedGrids[tileIndex]);
+					}
+				});
+		}
+
+		/// <summary>
+		/// Splits [0, count) over the thread pool, or just runs it all here if we don't have one
+		/// </summary>
+		template<class RangeFn>
+		void ParallelFor(size_t count, size_t grainSize, const RangeFn& fn) const
+		{
+			if (m_threadPool == nullptr)
+			{
+				if (count != 0)
+				{
+					fn(0, count);
+				}
+				return;
+			}
+
+			m_threadPool->ParallelFor(count, grainSize, fn);
+		}
+
 		/// <summary>
 		/// If we need a new board, make a new one in the sparse grid and hook it up to any adjacent existing boards
 		/// </summary>
 		/// <param name="macroCoord">The coord that represents the sparse coordinate system the boards live in</param>
 		ConnectedGrid& CreateAndHookUpBoard(const Coord& macroCoord)
 		{
-			ConnectedGrid& newBoard = m_connectedGrids.emplace(macroCoord, m_subBoardCreationFn()).first->second;
+			ConnectedGrid& newBoard = m_connectedGrids.FindOrCreate(macroCoord);
 
-			HookUpBoard(macroCoord, newBoard);
+			HookUpBoard(newBoard);
 
 			return newBoard;
 		}
 
 		/// <summary>
-		/// I'm going to proactively create neighbors when we specifically make 
+		/// I'm going to proactively create neighbors when we specifically make
 		/// </summary>
-		/// <param name="macroCoord"></param>
 		/// <param name="board"></param>
-		void HookUpBoard(const Coord& macroCoord, ConnectedGrid& board)
+		void HookUpBoard(ConnectedGrid& board)
 		{
+			const Coord& macroCoord = board.macroCoord;
+
 			if (board.north == nullptr)
 			{
-				auto north = m_connectedGrids.emplace(Coord{ macroCoord.x, macroCoord.y - 1 }, m_subBoardCreationFn());
-				board.north = &north.first->second;
-				north.first->second.south = &board;
+				ConnectedGrid& north = m_connectedGrids.FindOrCreate(Coord{ macroCoord.x, macroCoord.y - 1 });
+				board.north = &north;
+				north.south = &board;
 			}
 
 			if (board.south == nullptr)
 			{
-				auto south = m_connectedGrids.emplace(Coord{ macroCoord.x, macroCoord.y + 1 }, m_subBoardCreationFn());
-				board.south = &south.first->second;
-				south.first->second.north = &board;
+				ConnectedGrid& south = m_connectedGrids.FindOrCreate(Coord{ macroCoord.x, macroCoord.y + 1 });
+				board.south = &south;
+				south.north = &board;
 			}
 
 			if (board.east == nullptr)
 			{
-				auto east = m_connectedGrids.emplace(Coord{ macroCoord.x + 1, macroCoord.y }, m_subBoardCreationFn());
-				board.east = &east.first->second;
-				east.first->second.west = &board;
+				ConnectedGrid& east = m_connectedGrids.FindOrCreate(Coord{ macroCoord.x + 1, macroCoord.y });
+				board.east = &east;
+				east.west = &board;
 			}
 
 			if (board.west == nullptr)
 			{
-				auto west = m_connectedGrids.emplace(Coord{ macroCoord.x - 1, macroCoord.y }, m_subBoardCreationFn());
-				board.west = &west.first->second;
-				west.first->second.east = &board;
+				ConnectedGrid& west = m_connectedGrids.FindOrCreate(Coord{ macroCoord.x - 1, macroCoord.y });
+				board.west = &west;
+				west.east = &board;
 			}
 		}
 
 		const Unit m_gridSize;
 		GameBoardCreationFn m_subBoardCreationFn;
-		std::map<Coord, ConnectedGrid, LessCoord> m_connectedGrids;
+		TileTable m_connectedGrids;
 
-		//std::unordered_map<Coord, ConnectedGrid, HashCoord, EqualCoord> m_connectedGrids;
+		//Only made if we were asked for more than one worker
+		std::unique_ptr<ThreadPool> m_threadPool;
+
+		//Where SetCellRow lines up pieces of a row that don't start on a word boundary
+		Memory::TrackedVector<uint64_t, Memory::Subsystem::Cells> m_rowScratch;
+
+		//The run of cells SetCells is collecting for one grid, kept around so batches don't have to allocate
+		Memory::TrackedVector<Coord, Memory::Subsystem::Cells> m_localCells;
+
+		//Every grid's hash added up, as of the last GetBoardHash. Grids marked dirty since then haven't been counted yet.
+		mutable UnsignedUnit m_hash;
+
+		//What the grids added up to at the end of the last generation
+		UnsignedUnit m_population;
+		Coord m_boundsMin;
+		Coord m_boundsMax;
 	};
 }
 
-IGameBoardPtr GameBoard::CreateMultiGridBoard(GameBoardCreationFn subBoardCreationFn)
+IGameBoardPtr GameBoard::CreateMultiGridBoard(GameBoardCreationFn subBoardCreationFn, unsigned workerCount)
 {
-	return std::make_unique<MultiGridBoard>(subBoardCreationFn);
-}
\ No newline at end of file
+	return std::make_unique<MultiGridBoard>(subBoardCreationFn, workerCount);
+}
@@ -0,0 +1,362 @@
+#include "../GameBoardInterface.h"
+#include "../GameBoardSimd.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+using namespace GameBoard;
+
+namespace
+{
+	/// <summary>
+	/// The "cheater mode" from the notes at the bottom of GameBoardInterface.h. Nothing in the game of life moves faster than a cell a
+	/// generation, so if we know where the pattern starts and how many generations we're running, we know every cell it can ever reach,
+	/// and the whole board can be one bit plane made up front. There's no tiles to make, hook up, pad or throw away, stepping is the
+	/// strip kernel run straight down the plane, and the only memory it ever asks for is in the constructor.
+	///
+	/// It's laid out like the SimdGridBoard, 64 column strips one word per row with a dead cell of padding all the way round, just sized
+	/// at runtime and placed anywhere. Running it for more generations than it was sized for is allowed but it's no longer the infinite
+	/// board then, cells that get to the padding die there.
+	/// </summary>
+	class PreallocatedGridBoard : public IGameBoard
+	{
+	private:
+		static constexpr int paddingSize = 1;
+
+	public:
+		/// <param name="origin">Where the first cell inside the padding sits</param>
+		/// <param name="stripCount">How many 64 column strips wide the plane is, padding included</param>
+		/// <param name="rowCount">How many rows tall the plane is, padding included</param>
+		PreallocatedGridBoard(const Coord& origin, int stripCount, int rowCount) :
+			m_origin(origin),
+			m_stripCount(stripCount),
+			m_rowCount(rowCount),
+			//Both buffers, then a strip that's always empty for the kernel to use past the first and last strips
+			m_bits(static_cast<size_t>(2 * stripCount + 1) * rowCount),
+			m_stepStrip(nullptr)
+		{
+			Clear();
+		}
+
+		void Clear()
+		{
+			swapChain = false;
+			std::fill(m_bits.begin(), m_bits.end(), 0ull);
+			m_statsKnown = true;
+			m_population = 0;
+		}
+
+		/// <summary>
+		/// Same as the SimdGridBoard, empty means neither buffer has anything in it. Nobody tiles this board so nobody asks often enough
+		/// for it to be worth remembering.
+		/// </summary>
+		bool Empty()
+		{
+			return std::all_of(m_bits.begin(), m_bits.end(), [](uint64_t word) { return word == 0; });
+		}
+
+		bool GetCell(const Coord& position) const
+		{
+			const uint64_t* word = FindWord(swapChain, position);
+			return word != nullptr && ((*word >> PlaneColumn(position) % 64) & 1);
+		}
+
+		bool GetCurrentCell(const Coord& position) const
+		{
+			const uint64_t* word = FindWord(!swapChain, position);
+			return word != nullptr && ((*word >> PlaneColumn(position) % 64) & 1);
+		}
+
+		/// <summary>
+		/// Cells outside the plane are discarded, the same as any other bounded board
+		/// </summary>
+		void SetCell(const Coord& position, bool value)
+		{
+			if (uint64_t* word = const_cast<uint64_t*>(FindWord(!swapChain, position)))
+			{
+				const uint64_t bit = 1ull << (PlaneColumn(position) % 64);
+				*word = value ? (*word | bit) : (*word & ~bit);
+			}
+		}
+
+		void SetCells(std::span<const Coord> cells, bool value)
+		{
+			for (const Coord& cell : cells)
+			{
+				SetCell(cell, value);
+			}
+		}
+
+		Unit MaximumBoardLength()
+		{
+			return std::max<Unit>(m_stripCount * 64, m_rowCount) - paddingSize * 2;
+		}
+
+		/// <summary>
+		/// The plane is everything, and it never changes size
+		/// </summary>
+		UnsignedUnit GetBytesResident() const
+		{
+			return sizeof(*this) + m_bits.capacity() * sizeof(uint64_t);
+		}
+
+		void FinishCurrentGeneration()
+		{
+			swapChain = !swapChain;
+			m_statsKnown = false;
+		}
+
+		bool CurrentGenerationChanged() const
+		{
+			const size_t planeWords = static_cast<size_t>(m_stripCount) * m_rowCount;
+			return !std::equal(m_bits.begin(), m_bits.begin() + planeWords, m_bits.begin() + planeWords);
+		}
+
+		/// <summary>
+		/// Every strip of the plane through the kernel picked for this CPU, and that's the whole generation
+		/// </summary>
+		void IterateCurrentGenerationBoard(const RuleMasks& rule)
+		{
+			if (m_stepStrip == nullptr || rule != m_cachedRule)
+			{
+				m_cachedRule = rule;
+				m_stepStrip = SelectStepStripFn(m_cachedRule);
+			}
+
+			const uint64_t* emptyStrip = Strip(2, 0);
+			for (int strip = 0; strip < m_stripCount; ++strip)
+			{
+				m_stepStrip(strip > 0 ? Strip(swapChain, strip - 1) : emptyStrip,
+					Strip(swapChain, strip),
+					strip < m_stripCount - 1 ? Strip(swapChain, strip + 1) : emptyStrip,
+					const_cast<uint64_t*>(Strip(!swapChain, strip)),
+					m_rowCount,
+					InteriorColumns(strip),
+					m_cachedRule);
+			}
+		}
+
+		void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const
+		{
+			VisitAliveCells(parentCoord, fn);
+		}
+
+		void CollectCurrentGenerationAliveCells(const Coord& parentCoord, AliveCellBlock& block) const
+		{
+			VisitAliveCells(parentCoord, [&block](const Coord& cell) { block.Push(cell); });
+		}
+
+		/// <summary>
+		/// Word at a time through the lookup tables like the SimdGridBoard, then moved over to where the plane sits
+		/// </summary>
+		UnsignedUnit GetBoardHash() const
+		{
+			UnsignedUnit hash = 0;
+			for (int strip = 0; strip < m_stripCount; ++strip)
+			{
+				const uint64_t* bits = Strip(swapChain, strip);
+				const uint64_t interiorColumns = InteriorColumns(strip);
+				const uint64_t stripPower = HashPower(boardHashXBase, static_cast<UnsignedUnit>(strip * 64 - paddingSize));
+
+				uint64_t rowPower = 1;
+				for (int row = paddingSize; row < m_rowCount - paddingSize; ++row, rowPower *= boardHashYBase)
+				{
+					const uint64_t word = bits[row] & interiorColumns;
+					if (word != 0)
+					{
+						hash += HashRowWord(word) * stripPower * rowPower;
+					}
+				}
+			}
+			return TranslateBoardHash(hash, m_origin);
+		}
+
+		UnsignedUnit GetPopulation() const
+		{
+			UpdateStats();
+			return m_population;
+		}
+
+		bool GetBoundingBox(Coord& min, Coord& max) const
+		{
+			UpdateStats();
+			if (m_population == 0)
+			{
+				return false;
+			}
+
+			min = m_boundsMin;
+			max = m_boundsMax;
+			return true;
+		}
+
+	private:
+		const uint64_t* Strip(int buffer, int strip) const
+		{
+			return m_bits.data() + (static_cast<size_t>(buffer) * m_stripCount + strip) * m_rowCount;
+		}
+
+		uint64_t InteriorColumns(int strip) const
+		{
+			uint64_t interiorColumns = ~0ull;
+			if (strip == 0)
+			{
+				interiorColumns &= ~1ull;
+			}
+			if (strip == m_stripCount - 1)
+			{
+				interiorColumns &= ~(1ull << 63);
+			}
+			return interiorColumns;
+		}
+
+		Unit PlaneColumn(const Coord& position) const
+		{
+			return position.x - m_origin.x + paddingSize;
+		}
+
+		/// <summary>
+		/// The word holding a cell in one of the buffers, padding included, or nullptr if the cell is off the plane
+		/// </summary>
+		const uint64_t* FindWord(bool buffer, const Coord& position) const
+		{
+			//Unsigned so that cells far enough away for the subtraction to wrap still land off the plane
+			const UnsignedUnit column = static_cast<UnsignedUnit>(position.x) - static_cast<UnsignedUnit>(m_origin.x) + paddingSize;
+			const UnsignedUnit row = static_cast<UnsignedUnit>(position.y) - static_cast<UnsignedUnit>(m_origin.y) + paddingSize;
+			if (column >= static_cast<UnsignedUnit>(m_stripCount) * 64 || row >= static_cast<UnsignedUnit>(m_rowCount))
+			{
+				return nullptr;
+			}
+
+			return Strip(buffer, static_cast<int>(column / 64)) + row;
+		}
+
+		/// <summary>
+		/// Counts the front buffer and finds its edges in one pass, at most once a generation and only if someone asks
+		/// </summary>
+		void UpdateStats() const
+		{
+			if (m_statsKnown)
+			{
+				return;
+			}
+
+			m_population = 0;
+			int firstStrip = m_stripCount;
+			int lastStrip = 0;
+			uint64_t firstColumns = 0;
+			uint64_t lastColumns = 0;
+			int firstRow = m_rowCount;
+			int lastRow = 0;
+			for (int strip = 0; strip < m_stripCount; ++strip)
+			{
+				const uint64_t* bits = Strip(swapChain, strip);
+				const uint64_t interiorColumns = InteriorColumns(strip);
+
+				uint64_t columns = 0;
+				for (int row = paddingSize; row < m_rowCount - paddingSize; ++row)
+				{
+					const uint64_t word = bits[row] & interiorColumns;
+					if (word != 0)
+					{
+						m_population += std::popcount(word);
+						columns |= word;
+						firstRow = std::min(firstRow, row);
+						lastRow = std::max(lastRow, row);
+					}
+				}
+
+				if (columns != 0)
+				{
+					if (firstStrip == m_stripCount)
+					{
+						firstStrip = strip;
+						firstColumns = columns;
+					}
+					lastStrip = strip;
+					lastColumns = columns;
+				}
+			}
+
+			if (m_population != 0)
+			{
+				m_boundsMin = Coord{ m_origin.x + firstStrip * 64 + std::countr_zero(firstColumns) - paddingSize, m_origin.y + firstRow - paddingSize };
+				m_boundsMax = Coord{ m_origin.x + lastStrip * 64 + 64 - std::countl_zero(lastColumns) - paddingSize, m_origin.y + lastRow + 1 - paddingSize };
+			}
+			m_statsKnown = true;
+		}
+
+		/// <summary>
+		/// A row at a time across every strip, so cells come out in the same order LessCoord puts them in
+		/// </summary>
+		template<class CellFn>
+		void VisitAliveCells(const Coord& parentCoord, CellFn&& fn) const
+		{
+			const Coord origin{ m_origin.x + parentCoord.x - paddingSize, m_origin.y + parentCoord.y - paddingSize };
+			for (int row = paddingSize; row < m_rowCount - paddingSize; ++row)
+			{
+				for (int strip = 0; strip < m_stripCount; ++strip)
+				{
+					uint64_t word = Strip(swapChain, strip)[row] & InteriorColumns(strip);
+					while (word != 0)
+					{
+						const int bit = std::countr_zero(word);
+						word &= word - 1;
+
+						fn(Coord{ origin.x + strip * 64 + bit, origin.y + row });
+					}
+				}
+			}
+		}
+
+		const Coord m_origin;
+		const int m_stripCount;
+		const int m_rowCount;
+
+		bool swapChain;
+		Memory::TrackedVector<uint64_t, Memory::Subsystem::Boards> m_bits;
+
+		//Population and bounding box of the front buffer, only trusted while m_statsKnown is set
+		mutable bool m_statsKnown;
+		mutable UnsignedUnit m_population;
+		mutable Coord m_boundsMin;
+		mutable Coord m_boundsMax;
+
+		RuleMasks m_cachedRule;
+		StepStripFn m_stepStrip;
+	};
+}
+
+IGameBoardPtr GameBoard::CreatePreallocatedGridBoard(const Coord& min, const Coord& max, UnsignedUnit generations, UnsignedUnit maximumBytes)
+{
+	//Everything the pattern can reach is the box grown by a cell a generation, then there's a cell of padding on top. All done unsigned
+	//and kept well away from overflowing, since a pattern spread across the whole 64 bit space is a perfectly good pattern that just
+	//can't go on this board.
+	const UnsignedUnit limit = std::numeric_limits<int>::max() / 4;
+	const UnsignedUnit width = max.x > min.x ? static_cast<UnsignedUnit>(max.x) - static_cast<UnsignedUnit>(min.x) : 0;
+	const UnsignedUnit height = max.y > min.y ? static_cast<UnsignedUnit>(max.y) - static_cast<UnsignedUnit>(min.y) : 0;
+	if (width > limit || height > limit || generations > limit)
+	{
+		return nullptr;
+	}
+
+	const UnsignedUnit columns = width + 2 * generations + 2;
+	const UnsignedUnit rows = std::max<UnsignedUnit>(height + 2 * generations + 2, minimumStripRows);
+	const UnsignedUnit stripCount = (columns + 63) / 64;
+	if ((2 * stripCount + 1) * rows * sizeof(uint64_t) > maximumBytes)
+	{
+		return nullptr;
+	}
+
+	//The plane has to fit in the 64 bit space too, or cells near the edges would have nowhere to go
+	const Unit reach = static_cast<Unit>(generations) + 1;
+	if (min.x < std::numeric_limits<Unit>::min() + reach || min.y < std::numeric_limits<Unit>::min() + reach ||
+		min.x > std::numeric_limits<Unit>::max() - static_cast<Unit>(stripCount * 64) || min.y > std::numeric_limits<Unit>::max() - static_cast<Unit>(rows))
+	{
+		return nullptr;
+	}
+
+	//The origin is the first cell inside the padding
+	return std::make_unique<PreallocatedGridBoard>(Coord{ min.x - reach + 1, min.y - reach + 1 }, static_cast<int>(stripCount), static_cast<int>(rows));
+}
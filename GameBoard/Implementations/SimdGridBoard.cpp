@@ -0,0 +1,622 @@
+#include "../GameBoardInterface.h"
+#include "../GameBoardRules.h"
+#include "../GameBoardSimd.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+using namespace GameBoard;
+
+namespace
+{
+	/// <summary>
+	/// A bigger cousin of the StaticGridBoard meant for dense areas. The board is split into vertical strips 64 columns wide and each strip
+	/// is stored as one 64 bit word per row, which lets us step a strip with whatever vector width the CPU has. The outermost column
+	/// on each side and the top and bottom rows are padding, the same as the StaticGridBoard, so it can be used under a MultiGridBoard.
+	/// </summary>
+	/// <typeparam name="stripCount">How many 64 column strips wide the board is. The board is square so it is also stripCount * 64 rows
+	/// tall, and each of its two buffers takes stripCount^2 * 512 bytes.</typeparam>
+	template<int stripCount>
+	class SimdGridBoard : public IGameBoard
+	{
+	private:
+		static constexpr int paddingSize = 1;
+		static constexpr int rowCount = stripCount * 64;
+		static constexpr int gridSize = rowCount - paddingSize * 2;
+		using Strip = uint64_t[rowCount];
+		static_assert(rowCount >= minimumStripRows, "Strips need a register's worth of rows that aren't padding");
+
+	public:
+		SimdGridBoard() : m_stepStrip(nullptr)
+		{
+			Clear();
+		}
+
+		void Clear()
+		{
+			swapChain = false;
+			std::fill(&m_gridBits[0][0][0], &m_gridBits[0][0][0] + 2 * stripCount * rowCount, 0ull);
+			m_emptyKnown = true;
+			m_empty = true;
+			m_statsKnown = true;
+			m_population = 0;
+		}
+
+		/// <summary>
+		/// Same idea as the StaticGridBoard, we're empty if neither buffer has a bit set, padding included. The boards are big enough that
+		/// scanning them isn't free, and the MultiGridBoard asks a lot, so remember the answer until something gets written.
+		/// </summary>
+		bool Empty()
+		{
+			if (!m_emptyKnown)
+			{
+				const uint64_t* bits = &m_gridBits[0][0][0];
+				m_empty = std::all_of(bits, bits + 2 * stripCount * rowCount, [](uint64_t word) { return word == 0; });
+				m_emptyKnown = true;
+			}
+			return m_empty;
+		}
+
+		/// <summary>
+		/// Get a cell's alive status at the position. Cells outside the grid and its padding are always dead.
+		/// </summary>
+		/// <param name="position">The position of the cell we wish to check. Between [-1, gridSize]</param>
+		bool GetCell(const Coord& position) const
+		{
+			return TestBit(m_gridBits[swapChain], position);
+		}
+
+		/// <summary>
+		/// Get a cell's alive status at the position in the generation being written. Cells outside the grid and its padding are always dead.
+		/// </summary>
+		/// <param name="position">The position of the cell we wish to check. Between [-1, gridSize]</param>
+		bool GetCurrentCell(const Coord& position) const
+		{
+			return TestBit(m_gridBits[!swapChain], position);
+		}
+
+		/// <summary>
+		/// Set a cell's alive status in the generation being written. Cells outside the grid and its padding are discarded.
+		/// </summary>
+		/// <param name="position">The position of the alive cell we wish to set. Between [-1, gridSize]</param>
+		void SetCell(const Coord& position, bool value)
+		{
+			const Unit column = position.x + paddingSize;
+			const Unit row = position.y + paddingSize;
+			if (column < 0 || column >= rowCount || row < 0 || row >= rowCount)
+			{
+				return;
+			}
+
+			uint64_t& word = m_gridBits[!swapChain][column / 64][row];
+			const uint64_t bit = 1ull << (column % 64);
+			word = value ? (word | bit) : (word & ~bit);
+
+			if (value)
+			{
+				m_emptyKnown = true;
+				m_empty = false;
+			}
+			else if (!m_empty)
+			{
+				//Clearing a bit on an empty board keeps it empty, otherwise we'd have to look
+				m_emptyKnown = false;
+			}
+		}
+
+		/// <summary>
+		/// Same as SetCell for each of them, but the empty flag only gets worked out once for the lot
+		/// </summary>
+		void SetCells(std::span<const Coord> cells, bool value)
+		{
+			bool anySet = false;
+			for (const Coord& cell : cells)
+			{
+				const Unit column = cell.x + paddingSize;
+				const Unit row = cell.y + paddingSize;
+				if (column < 0 || column >= rowCount || row < 0 || row >= rowCount)
+				{
+					continue;
+				}
+
+				uint64_t& word = m_gridBits[!swapChain][column / 64][row];
+				const uint64_t bit = 1ull << (column % 64);
+				word = value ? (word | bit) : (word & ~bit);
+				anySet = true;
+			}
+
+			if (!anySet)
+			{
+				return;
+			}
+
+			if (value)
+			{
+				m_emptyKnown = true;
+				m_empty = false;
+			}
+			else if (!m_empty)
+			{
+				m_emptyKnown = false;
+			}
+		}
+
+		/// <summary>
+		/// A run only touches one word per strip it crosses
+		/// </summary>
+		void SetCellRun(const Coord& start, Unit length, bool value)
+		{
+			const Unit row = start.y + paddingSize;
+			const Unit firstColumn = std::max<Unit>(start.x + paddingSize, 0);
+			const Unit lastColumn = std::min<Unit>(start.x + paddingSize + length, rowCount);
+			if (firstColumn >= lastColumn || row < 0 || row >= rowCount)
+			{
+				return;
+			}
+
+			for (Unit column = firstColumn; column < lastColumn; column = (column / 64 + 1) * 64)
+			{
+				const int firstBit = static_cast<int>(column % 64);
+				const int bitCount = static_cast<int>(std::min<Unit>(lastColumn - column, 64 - firstBit));
+				const uint64_t bits = (bitCount == 64 ? ~0ull : ((1ull << bitCount) - 1)) << firstBit;
+
+				uint64_t& word = m_gridBits[!swapChain][column / 64][row];
+				word = value ? (word | bits) : (word & ~bits);
+			}
+
+			if (value)
+			{
+				m_emptyKnown = true;
+				m_empty = false;
+			}
+			else if (!m_empty)
+			{
+				m_emptyKnown = false;
+			}
+		}
+
+		/// <summary>
+		/// Rows are already words, one per strip, so this is just lining them back up with where the row starts
+		/// </summary>
+		void GetCellRow(const Coord& start, Unit length, uint64_t* bits) const
+		{
+			std::fill(bits, bits + (length + 63) / 64, 0ull);
+
+			const Unit row = start.y + paddingSize;
+			const Unit firstColumn = std::max<Unit>(start.x + paddingSize, 0);
+			const Unit lastColumn = std::min<Unit>(start.x + paddingSize + length, rowCount);
+			if (firstColumn >= lastColumn || row < 0 || row >= rowCount)
+			{
+				return;
+			}
+
+			for (Unit column = firstColumn; column < lastColumn; column = (column / 64 + 1) * 64)
+			{
+				const int firstBit = static_cast<int>(column % 64);
+				const int bitCount = static_cast<int>(std::min<Unit>(lastColumn - column, 64 - firstBit));
+				WriteRowBits(bits, column - (start.x + paddingSize), bitCount, m_gridBits[swapChain][column / 64][row] >> firstBit);
+			}
+		}
+
+		/// <summary>
+		/// Like SetCellRun, a row only touches one word per strip it crosses
+		/// </summary>
+		void SetCellRow(const Coord& start, Unit length, const uint64_t* bits)
+		{
+			const Unit row = start.y + paddingSize;
+			const Unit firstColumn = std::max<Unit>(start.x + paddingSize, 0);
+			const Unit lastColumn = std::min<Unit>(start.x + paddingSize + length, rowCount);
+			if (firstColumn >= lastColumn || row < 0 || row >= rowCount)
+			{
+				return;
+			}
+
+			uint64_t anyAlive = 0;
+			for (Unit column = firstColumn; column < lastColumn; column = (column / 64 + 1) * 64)
+			{
+				const int firstBit = static_cast<int>(column % 64);
+				const int bitCount = static_cast<int>(std::min<Unit>(lastColumn - column, 64 - firstBit));
+				const uint64_t mask = (bitCount == 64 ? ~0ull : ((1ull << bitCount) - 1)) << firstBit;
+				const uint64_t cells = ReadRowBits(bits, column - (start.x + paddingSize), bitCount) << firstBit;
+
+				uint64_t& word = m_gridBits[!swapChain][column / 64][row];
+				word = (word & ~mask) | cells;
+				anyAlive |= cells;
+			}
+
+			if (anyAlive != 0)
+			{
+				m_emptyKnown = true;
+				m_empty = false;
+			}
+			else if (!m_empty)
+			{
+				m_emptyKnown = false;
+			}
+		}
+
+		/// <summary>
+		/// Rows are already words, they just need shifting over by the padding column. Columns are one bit out of each row's word,
+		/// and the rows of a strip sit next to each other in memory so that's a straight walk.
+		/// </summary>
+		void GetCurrentEdgeCells(Unit length, uint64_t* edges) const
+		{
+			if (length != gridSize)
+			{
+				IGameBoard::GetCurrentEdgeCells(length, edges);
+				return;
+			}
+
+			//Every strip gives one word of edge, the padding column shifted out of the bottom and the next strip's first column
+			//shifted into the top
+			static_assert(EdgeWords(gridSize) == stripCount, "The edge of a row needs to be one word per strip");
+			const Strip (&bits)[stripCount] = m_gridBits[!swapChain];
+			const uint64_t lastWordMask = (1ull << (gridSize % 64)) - 1;
+			for (int strip = 0; strip < stripCount; ++strip)
+			{
+				const bool last = strip == stripCount - 1;
+				edges[strip] = (bits[strip][paddingSize] >> 1) | (last ? 0 : bits[strip + 1][paddingSize] << 63);
+				edges[stripCount + strip] = (bits[strip][gridSize] >> 1) | (last ? 0 : bits[strip + 1][gridSize] << 63);
+			}
+			edges[stripCount - 1] &= lastWordMask;
+			edges[2 * stripCount - 1] &= lastWordMask;
+
+			uint64_t* left = edges + 2 * stripCount;
+			uint64_t* right = edges + 3 * stripCount;
+			std::fill(left, left + 2 * stripCount, 0ull);
+			for (int i = 0; i < gridSize; ++i)
+			{
+				left[i / 64] |= ((bits[0][i + paddingSize] >> paddingSize) & 1) << (i % 64);
+				right[i / 64] |= ((bits[stripCount - 1][i + paddingSize] >> 62) & 1) << (i % 64);
+			}
+		}
+
+		/// <summary>
+		/// The other way around from GetCurrentEdgeCells, with the corners going in the ends of the top and bottom rows
+		/// </summary>
+		void SetPaddingCells(Unit length, const uint64_t* padding)
+		{
+			if (length != gridSize)
+			{
+				IGameBoard::SetPaddingCells(length, padding);
+				return;
+			}
+
+			Strip (&bits)[stripCount] = m_gridBits[!swapChain];
+			const uint64_t* top = padding;
+			const uint64_t* bottom = padding + stripCount;
+			const uint64_t* left = padding + 2 * stripCount;
+			const uint64_t* right = padding + 3 * stripCount;
+			const uint64_t corners = padding[4 * stripCount];
+			const uint64_t lastWordMask = (1ull << (gridSize % 64)) - 1;
+
+			uint64_t anyAlive = corners & 0xF;
+			for (int strip = 0; strip < stripCount; ++strip)
+			{
+				const bool last = strip == stripCount - 1;
+				const uint64_t topWord = last ? top[strip] & lastWordMask : top[strip];
+				const uint64_t bottomWord = last ? bottom[strip] & lastWordMask : bottom[strip];
+				bits[strip][0] = (topWord << 1) | (strip == 0 ? 0 : top[strip - 1] >> 63);
+				bits[strip][rowCount - 1] = (bottomWord << 1) | (strip == 0 ? 0 : bottom[strip - 1] >> 63);
+				anyAlive |= topWord | bottomWord;
+			}
+			bits[0][0] |= corners & 1;
+			bits[stripCount - 1][0] |= ((corners >> 1) & 1) << 63;
+			bits[0][rowCount - 1] |= (corners >> 2) & 1;
+			bits[stripCount - 1][rowCount - 1] |= ((corners >> 3) & 1) << 63;
+
+			for (int i = 0; i < gridSize; ++i)
+			{
+				const uint64_t leftCell = (left[i / 64] >> (i % 64)) & 1;
+				const uint64_t rightCell = (right[i / 64] >> (i % 64)) & 1;
+				uint64_t& leftWord = bits[0][i + paddingSize];
+				uint64_t& rightWord = bits[stripCount - 1][i + paddingSize];
+				leftWord = (leftWord & ~1ull) | leftCell;
+				rightWord = (rightWord & ~(1ull << 63)) | (rightCell << 63);
+				anyAlive |= leftCell | rightCell;
+			}
+
+			if (anyAlive != 0)
+			{
+				m_emptyKnown = true;
+				m_empty = false;
+			}
+			else if (!m_empty)
+			{
+				m_emptyKnown = false;
+			}
+		}
+
+		/// <summary>
+		/// These are constrained to the size of the grid we allocated for them
+		/// </summary>
+		/// <returns>maximum allowable length</returns>
+		Unit MaximumBoardLength()
+		{
+			return gridSize;
+		}
+
+		/// <summary>
+		/// Both buffers live right in the object, so it's the same size no matter what's on it
+		/// </summary>
+		UnsignedUnit GetBytesResident() const
+		{
+			return sizeof(*this);
+		}
+
+		/// <summary>
+		/// Need to know when to swap to the second board
+		/// </summary>
+		void FinishCurrentGeneration()
+		{
+			swapChain = !swapChain;
+			m_statsKnown = false;
+		}
+
+		/// <summary>
+		/// Compares the buffers word by word. Padding gets compared too since masking it out isn't worth the trouble, which only means
+		/// we might say we changed when just the padding did, and then the board gets stepped when it didn't have to be.
+		/// </summary>
+		bool CurrentGenerationChanged() const
+		{
+			return !std::equal(&m_gridBits[0][0][0], &m_gridBits[0][0][0] + stripCount * rowCount, &m_gridBits[1][0][0]);
+		}
+
+		/// <summary>
+		/// Steps each strip with the kernel picked for this CPU
+		/// </summary>
+		/// <param name="rule">The rule to run the game of life with</param>
+		void IterateCurrentGenerationBoard(const RuleMasks& rule)
+		{
+			alignas(64) static const Strip emptyStrip = {};
+
+			if (m_stepStrip == nullptr || rule != m_cachedRule)
+			{
+				m_cachedRule = rule;
+				m_stepStrip = SelectStepStripFn(m_cachedRule);
+			}
+
+			for (int strip = 0; strip < stripCount; ++strip)
+			{
+				uint64_t interiorColumns = ~0ull;
+				if (strip == 0)
+				{
+					interiorColumns &= ~1ull;
+				}
+				if (strip == stripCount - 1)
+				{
+					interiorColumns &= ~(1ull << 63);
+				}
+
+				m_stepStrip(strip > 0 ? m_gridBits[swapChain][strip - 1] : emptyStrip,
+					m_gridBits[swapChain][strip],
+					strip < stripCount - 1 ? m_gridBits[swapChain][strip + 1] : emptyStrip,
+					m_gridBits[!swapChain][strip],
+					rowCount,
+					interiorColumns,
+					m_cachedRule);
+			}
+
+			m_emptyKnown = false;
+		}
+
+		/// <summary>
+		/// Walk the grid a row at a time, jumping straight to the set bits in each word.
+		/// </summary>
+		/// <param name="fn">The function to run on all the alive cells.</param>
+		void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const
+		{
+			VisitAliveCells(parentCoord, fn);
+		}
+
+		/// <summary>
+		/// Same walk, pushing into the block so there's no std::function call per cell
+		/// </summary>
+		void CollectCurrentGenerationAliveCells(const Coord& parentCoord, AliveCellBlock& block) const
+		{
+			VisitAliveCells(parentCoord, [&block](const Coord& cell) { block.Push(cell); });
+		}
+
+		/// <summary>
+		/// Hashes a word of a row at a time with the lookup tables, so cells never get looked at one by one. Each strip's words are
+		/// multiplied over to where the strip starts, and each row over to where the row is.
+		/// </summary>
+		UnsignedUnit GetBoardHash() const
+		{
+			//Where each strip starts, with the padding column taken off the first one
+			static constexpr auto stripPowers = []
+				{
+					std::array<uint64_t, stripCount> powers{};
+					for (int strip = 0; strip < stripCount; ++strip)
+					{
+						powers[strip] = HashPower(boardHashXBase, static_cast<UnsignedUnit>(strip * 64 - paddingSize));
+					}
+					return powers;
+				}();
+
+			UnsignedUnit hash = 0;
+			uint64_t rowPower = 1;
+			for (int row = paddingSize; row < rowCount - paddingSize; ++row, rowPower *= boardHashYBase)
+			{
+				uint64_t rowHash = 0;
+				for (int strip = 0; strip < stripCount; ++strip)
+				{
+					uint64_t word = m_gridBits[swapChain][strip][row];
+					if (strip == 0)
+					{
+						word &= ~1ull;
+					}
+					if (strip == stripCount - 1)
+					{
+						word &= ~(1ull << 63);
+					}
+
+					if (word != 0)
+					{
+						rowHash += HashRowWord(word) * stripPowers[strip];
+					}
+				}
+				hash += rowHash * rowPower;
+			}
+			return hash;
+		}
+
+		UnsignedUnit GetPopulation() const
+		{
+			UpdateStats();
+			return m_population;
+		}
+
+		bool GetBoundingBox(Coord& min, Coord& max) const
+		{
+			UpdateStats();
+			if (m_population == 0)
+			{
+				return false;
+			}
+
+			min = m_boundsMin;
+			max = m_boundsMax;
+			return true;
+		}
+
+	private:
+		/// <summary>
+		/// Counts the finished generation and finds its edges in one pass over the words. Only the front buffer counts and that only
+		/// changes when the generation is finished, so this is done at most once a generation, and only if someone asks.
+		/// </summary>
+		void UpdateStats() const
+		{
+			if (m_statsKnown)
+			{
+				return;
+			}
+
+			m_population = 0;
+			uint64_t columns[stripCount] = {};
+			int firstRow = rowCount;
+			int lastRow = 0;
+			for (int row = paddingSize; row < rowCount - paddingSize; ++row)
+			{
+				uint64_t rowBits = 0;
+				for (int strip = 0; strip < stripCount; ++strip)
+				{
+					uint64_t word = m_gridBits[swapChain][strip][row];
+					if (strip == 0)
+					{
+						word &= ~1ull;
+					}
+					if (strip == stripCount - 1)
+					{
+						word &= ~(1ull << 63);
+					}
+
+					m_population += std::popcount(word);
+					columns[strip] |= word;
+					rowBits |= word;
+				}
+
+				if (rowBits != 0)
+				{
+					firstRow = std::min(firstRow, row);
+					lastRow = row;
+				}
+			}
+
+			if (m_population != 0)
+			{
+				int firstStrip = 0;
+				while (columns[firstStrip] == 0)
+				{
+					++firstStrip;
+				}
+				int lastStrip = stripCount - 1;
+				while (columns[lastStrip] == 0)
+				{
+					--lastStrip;
+				}
+
+				m_boundsMin = Coord{ firstStrip * 64 + std::countr_zero(columns[firstStrip]) - paddingSize, firstRow - paddingSize };
+				m_boundsMax = Coord{ lastStrip * 64 + 64 - std::countl_zero(columns[lastStrip]) - paddingSize, lastRow + 1 - paddingSize };
+			}
+			m_statsKnown = true;
+		}
+
+		template<class CellFn>
+		void VisitAliveCells(const Coord& parentCoord, CellFn&& fn) const
+		{
+			for (int row = paddingSize; row < rowCount - paddingSize; ++row)
+			{
+				for (int strip = 0; strip < stripCount; ++strip)
+				{
+					uint64_t word = m_gridBits[swapChain][strip][row];
+					if (strip == 0)
+					{
+						word &= ~1ull;
+					}
+					if (strip == stripCount - 1)
+					{
+						word &= ~(1ull << 63);
+					}
+
+					while (word != 0)
+					{
+						const int bit = std::countr_zero(word);
+						word &= word - 1;
+
+						fn(Coord{ strip * 64 + bit - paddingSize + parentCoord.x, row - paddingSize + parentCoord.y });
+					}
+				}
+			}
+		}
+
+		static bool TestBit(const Strip (&bits)[stripCount], const Coord& position)
+		{
+			const Unit column = position.x + paddingSize;
+			const Unit row = position.y + paddingSize;
+			if (column < 0 || column >= rowCount || row < 0 || row >= rowCount)
+			{
+				return false;
+			}
+
+			return (bits[column / 64][row] >> (column % 64)) & 1;
+		}
+
+		bool swapChain;
+		alignas(64) Strip m_gridBits[2][stripCount];
+
+		//Cached answer to Empty(), only trusted while m_emptyKnown is set
+		bool m_emptyKnown;
+		bool m_empty;
+
+		//Population and bounding box of the front buffer, only trusted while m_statsKnown is set
+		mutable bool m_statsKnown;
+		mutable UnsignedUnit m_population;
+		mutable Coord m_boundsMin;
+		mutable Coord m_boundsMax;
+
+		//The last rule we were asked to run and the kernel for it, so we don't pick the kernel again every generation
+		RuleMasks m_cachedRule;
+		StepStripFn m_stepStrip;
+	};
+}
+
+//4 strips gives a 254x254 board, 16KB for both buffers. That's enough rows that even AVX-512 gets 32 steps through each strip,
+//while still being small enough that the MultiGridBoard isn't carrying around huge empty tiles at the edges of a pattern.
+IGameBoardPtr GameBoard::CreateSimdGridBoard()
+{
+	return std::make_unique<SimdGridBoard<4>>();
+}
+
+//1 strip is a 62x62 board, one word per row. Too narrow for AVX-512 to do much, but sparse patterns spend less time stepping empty space.
+IGameBoardPtr GameBoard::CreateSimdGridBoard62()
+{
+	return std::make_unique<SimdGridBoard<1>>();
+}
+
+//16 strips is a 1022x1022 board, 256KB for both buffers, for soups that fill a lot of space and stay that way
+IGameBoardPtr GameBoard::CreateSimdGridBoard1022()
+{
+	return std::make_unique<SimdGridBoard<16>>();
+}
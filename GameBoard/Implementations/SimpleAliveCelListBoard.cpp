@@ -8,9 +8,16 @@ namespace
 	class SimpleAliveCellListBoard : public IGameBoard
 	{
 	public:
+		SimpleAliveCellListBoard() : m_boundsKnown(true)
+		{
+
+		}
+
 		void Clear()
 		{
 			m_aliveCells.clear();
+			m_bounds = BoundsBuilder();
+			m_boundsKnown = true;
 		}
 
 		bool Empty()
@@ -45,10 +52,17 @@ namespace
 			if (value == true)
 			{
 				m_aliveCells.insert(position);
+				m_bounds.Add(position);
 			}
-			else
+			else if (m_aliveCells.erase(position) != 0 && m_boundsKnown)
 			{
-				m_aliveCells.erase(position);
+				//Taking a cell off the edge might pull the edge in, but we can't tell how far without looking at the rest
+				Coord min;
+				Coord max;
+				if (m_bounds.Get(min, max))
+				{
+					m_boundsKnown = position.x != min.x && position.y != min.y && position.x + 1 != max.x && position.y + 1 != max.y;
+				}
 			}
 		}
 
@@ -61,6 +75,14 @@ namespace
 			return std::numeric_limits<Unit>::max();
 		}
 
+		/// <summary>
+		/// Every cell is a tree node, which is the cell plus three pointers and a color
+		/// </summary>
+		UnsignedUnit GetBytesResident() const
+		{
+			return sizeof(*this) + m_aliveCells.size() * (sizeof(Coord) + 4 * sizeof(void*));
+		}
+
 		/// <summary>
 		/// Does nothing
 		/// </summary>
@@ -69,8 +91,8 @@ namespace
 		/// <summary>
 		/// Does nothing
 		/// </summary>
-		/// <param name="gameSim"></param>
-		void IterateCurrentGenerationBoard(GameSimFn gameSim) {}
+		/// <param name="rule"></param>
+		void IterateCurrentGenerationBoard(const RuleMasks& rule) {}
 
 		/// <summary>
 		/// Since this only stores the cells that are alive in the first place, running a function only on the alive cells is trivial.
@@ -84,9 +106,43 @@ namespace
 			}
 		}
 
+		void CollectCurrentGenerationAliveCells(const Coord& parentCoord, AliveCellBlock& block) const
+		{
+			for (const Coord& aliveCell : m_aliveCells)
+			{
+				block.Push(aliveCell);
+			}
+		}
+
+		UnsignedUnit GetPopulation() const
+		{
+			return m_aliveCells.size();
+		}
+
+		/// <summary>
+		/// Cells only ever push the box out as they're added. It only needs working out again after a cell on its edge goes away.
+		/// </summary>
+		bool GetBoundingBox(Coord& min, Coord& max) const
+		{
+			if (!m_boundsKnown)
+			{
+				m_bounds = BoundsBuilder();
+				for (const Coord& aliveCell : m_aliveCells)
+				{
+					m_bounds.Add(aliveCell);
+				}
+				m_boundsKnown = true;
+			}
+			return m_bounds.Get(min, max);
+		}
+
 	private:
-		using CoordSet = std::set<Coord, LessCoord>;
+		using CoordSet = std::set<Coord, LessCoord, Memory::TrackingAllocator<Coord, Memory::Subsystem::Cells>>;
 		CoordSet m_aliveCells;
+
+		//Grows with every cell added, only trusted while m_boundsKnown is set
+		mutable BoundsBuilder m_bounds;
+		mutable bool m_boundsKnown;
 	};
 }
 
@@ -1,4 +1,7 @@
 #include "../GameBoardInterface.h"
+#include "../GameBoardRules.h"
+#include <algorithm>
+#include <bit>
 #include <bitset>
 
 using namespace GameBoard;
@@ -23,6 +26,36 @@ namespace
 		static constexpr int gridSizeWithPadding1D= gridSizeWithPadding * gridSizeWithPadding;
 		using GridBits = std::bitset<gridSizeWithPadding1D>;
 
+		/// <summary>
+		/// Bits for every cell in the grid that isn't padding
+		/// </summary>
+		static GridBits MakeInteriorMask()
+		{
+			GridBits mask;
+			for (int y = paddingSize; y < gridSize + paddingSize; ++y)
+			{
+				for (int x = paddingSize; x < gridSize + paddingSize; ++x)
+				{
+					mask.set(x + y * gridSizeWithPadding);
+				}
+			}
+			return mask;
+		}
+
+		/// <summary>
+		/// Where a cell lives in the bitset, for coordinates we already know are in range
+		/// </summary>
+		static constexpr int BitIndex(int x, int y)
+		{
+			return (x + paddingSize) + (y + paddingSize) * gridSizeWithPadding;
+		}
+
+		static const GridBits& InteriorMask()
+		{
+			static const GridBits interiorMask = MakeInteriorMask();
+			return interiorMask;
+		}
+
 	public:
 		StaticGridBoard()
 		{
@@ -93,6 +126,153 @@ namespace
 			}
 		}
 
+		/// <summary>
+		/// Same as SetCell for each of them, just without a virtual call per cell
+		/// </summary>
+		void SetCells(std::span<const Coord> cells, bool value)
+		{
+			GridBits& bits = m_gridBits[!swapChain];
+			for (const Coord& cell : cells)
+			{
+				Unit coord1D = 0;
+				if (Get1DIndexFromCoord(cell, gridSizeWithPadding, paddingSize, coord1D) && coord1D < gridSizeWithPadding1D)
+				{
+					bits.set(coord1D, value);
+				}
+			}
+		}
+
+		/// <summary>
+		/// A row is a contiguous set of bits, so the whole run is one shifted mask
+		/// </summary>
+		void SetCellRun(const Coord& start, Unit length, bool value)
+		{
+			//Same limits as SetCell, which lets the padding be written too
+			const Unit firstColumn = std::max<Unit>(start.x, -paddingSize);
+			const Unit lastColumn = std::min<Unit>(start.x + length, gridSize + paddingSize);
+			if (firstColumn >= lastColumn || start.y < -paddingSize || start.y >= gridSize + paddingSize)
+			{
+				return;
+			}
+
+			Unit coord1D = 0;
+			Get1DIndexFromCoord(Coord{ firstColumn, start.y }, gridSizeWithPadding, paddingSize, coord1D);
+			const GridBits run = (~GridBits() >> (gridSizeWithPadding1D - (lastColumn - firstColumn))) << coord1D;
+
+			GridBits& bits = m_gridBits[!swapChain];
+			bits = value ? (bits | run) : (bits & ~run);
+		}
+
+		/// <summary>
+		/// Shifts the row down to the bottom of the bitset and pulls it out 64 cells at a time
+		/// </summary>
+		void GetCellRow(const Coord& start, Unit length, uint64_t* bits) const
+		{
+			std::fill(bits, bits + (length + 63) / 64, 0ull);
+
+			const Unit firstColumn = std::max<Unit>(start.x, -paddingSize);
+			const Unit lastColumn = std::min<Unit>(start.x + length, gridSize + paddingSize);
+			if (firstColumn >= lastColumn || start.y < -paddingSize || start.y >= gridSize + paddingSize)
+			{
+				return;
+			}
+
+			Unit coord1D = 0;
+			Get1DIndexFromCoord(Coord{ firstColumn, start.y }, gridSizeWithPadding, paddingSize, coord1D);
+			const GridBits row = m_gridBits[swapChain] >> coord1D;
+			for (Unit column = firstColumn; column < lastColumn; column += 64)
+			{
+				const int count = static_cast<int>(std::min<Unit>(lastColumn - column, 64));
+				const GridBits cells = (row >> (column - firstColumn)) & (~GridBits() >> (gridSizeWithPadding1D - count));
+				WriteRowBits(bits, column - start.x, count, cells.to_ullong());
+			}
+		}
+
+		/// <summary>
+		/// Same as SetCellRun, except the run is whatever the row says rather than all one value
+		/// </summary>
+		void SetCellRow(const Coord& start, Unit length, const uint64_t* bits)
+		{
+			const Unit firstColumn = std::max<Unit>(start.x, -paddingSize);
+			const Unit lastColumn = std::min<Unit>(start.x + length, gridSize + paddingSize);
+			if (firstColumn >= lastColumn || start.y < -paddingSize || start.y >= gridSize + paddingSize)
+			{
+				return;
+			}
+
+			GridBits row;
+			for (Unit column = lastColumn; column > firstColumn; )
+			{
+				const int count = static_cast<int>(std::min<Unit>(column - firstColumn, 64));
+				column -= count;
+				row = (row << count) | GridBits(ReadRowBits(bits, column - start.x, count));
+			}
+
+			Unit coord1D = 0;
+			Get1DIndexFromCoord(Coord{ firstColumn, start.y }, gridSizeWithPadding, paddingSize, coord1D);
+			const GridBits run = (~GridBits() >> (gridSizeWithPadding1D - (lastColumn - firstColumn))) << coord1D;
+
+			GridBits& grid = m_gridBits[!swapChain];
+			grid = (grid & ~run) | (row << coord1D);
+		}
+
+		/// <summary>
+		/// The edges are a handful of bit tests at indices the compiler can work out ahead of time, no coordinate checks needed
+		/// </summary>
+		void GetCurrentEdgeCells(Unit length, uint64_t* edges) const
+		{
+			if (length != gridSize)
+			{
+				IGameBoard::GetCurrentEdgeCells(length, edges);
+				return;
+			}
+
+			const GridBits& bits = m_gridBits[!swapChain];
+			constexpr size_t words = EdgeWords(gridSize);
+			std::fill(edges, edges + 4 * words, 0ull);
+			for (int i = 0; i < gridSize; ++i)
+			{
+				const uint64_t bit = 1ull << (i % 64);
+				edges[i / 64] |= bits.test(BitIndex(i, 0)) ? bit : 0;
+				edges[words + i / 64] |= bits.test(BitIndex(i, gridSize - 1)) ? bit : 0;
+				edges[2 * words + i / 64] |= bits.test(BitIndex(0, i)) ? bit : 0;
+				edges[3 * words + i / 64] |= bits.test(BitIndex(gridSize - 1, i)) ? bit : 0;
+			}
+		}
+
+		/// <summary>
+		/// Builds the whole ring of padding as its own bitset and swaps it in with one mask, the inside of the grid is left alone
+		/// </summary>
+		void SetPaddingCells(Unit length, const uint64_t* padding)
+		{
+			if (length != gridSize)
+			{
+				IGameBoard::SetPaddingCells(length, padding);
+				return;
+			}
+
+			constexpr size_t words = EdgeWords(gridSize);
+			GridBits paddingBits;
+			for (int i = 0; i < gridSize; ++i)
+			{
+				const int word = i / 64;
+				const int shift = i % 64;
+				paddingBits.set(BitIndex(i, -1), ((padding[word] >> shift) & 1) != 0);
+				paddingBits.set(BitIndex(i, gridSize), ((padding[words + word] >> shift) & 1) != 0);
+				paddingBits.set(BitIndex(-1, i), ((padding[2 * words + word] >> shift) & 1) != 0);
+				paddingBits.set(BitIndex(gridSize, i), ((padding[3 * words + word] >> shift) & 1) != 0);
+			}
+
+			const uint64_t corners = padding[4 * words];
+			paddingBits.set(BitIndex(-1, -1), (corners & 1) != 0);
+			paddingBits.set(BitIndex(gridSize, -1), (corners & 2) != 0);
+			paddingBits.set(BitIndex(-1, gridSize), (corners & 4) != 0);
+			paddingBits.set(BitIndex(gridSize, gridSize), (corners & 8) != 0);
+
+			GridBits& next = m_gridBits[!swapChain];
+			next = (next & InteriorMask()) | paddingBits;
+		}
+
 		/// <summary>
 		/// These are constrained to the size of the grid we allocated for them
 		/// </summary>
@@ -102,6 +282,14 @@ namespace
 			return gridSize;
 		}
 
+		/// <summary>
+		/// Both buffers live right in the object, so it's the same size no matter what's on it
+		/// </summary>
+		UnsignedUnit GetBytesResident() const
+		{
+			return sizeof(*this);
+		}
+
 		/// <summary>
 		/// Need to know when to swap to the second board
 		/// </summary>
@@ -111,86 +299,113 @@ namespace
 		}
 
 		/// <summary>
-		/// This one just walks the grid and looks at itself and the adjacent cells
+		/// The whole board fits in a bitset so just compare the two buffers, leaving the padding out
 		/// </summary>
-		/// <param name="gameSim">function that runs the game of life</param>
-		void IterateCurrentGenerationBoard(GameSimFn gameSim)
+		bool CurrentGenerationChanged() const
 		{
-			//Make my own array of bits which has a pattern for the areas we need to check for live cells.
-			GridBits testPattern = 0b111 | 0b101 << gridSizeWithPadding | 0b111 << gridSizeWithPadding * 2;
-			GridBits testedBits = 0;
-			Unit index = 0;
-			size_t numNeighborsSet = 0;
-			bool alive = false;
+			return ((m_gridBits[0] ^ m_gridBits[1]) & InteriorMask()).any();
+		}
 
-			Coord placement = { 0,0 };
-			for (placement.y = 0; placement.y < gridSize; ++placement.y)
-			{
-				for (placement.x = 0; placement.x < gridSize; ++placement.x)
-				{
-					testedBits = m_gridBits[swapChain] & testPattern;
-					numNeighborsSet = testedBits.count();
+		/// <summary>
+		/// Runs a whole generation at once instead of cell by cell. Each of the 8 neighbor directions is the front buffer shifted
+		/// over by one bitset shift, so the whole grid can go through NextGeneration in one go.
+		/// Shifting by 1 does bleed the last column of a row into the first column of the next, but those are padding columns
+		/// and we only ever keep the results for the cells inside the padding.
+		/// </summary>
+		/// <param name="rule">The rule to run the game of life with</param>
+		void IterateCurrentGenerationBoard(const RuleMasks& rule)
+		{
+			//Line each neighbor up with the cell it's next to
+			const GridBits& current = m_gridBits[swapChain];
+			const GridBits neighbors[8] = {
+				current << (gridSizeWithPadding + 1), current << gridSizeWithPadding, current << (gridSizeWithPadding - 1),
+				current << 1, current >> 1,
+				current >> (gridSizeWithPadding - 1), current >> gridSizeWithPadding, current >> (gridSizeWithPadding + 1) };
 
-					Get1DIndexFromCoord(placement, gridSizeWithPadding, paddingSize, index);
+			//The rule gets matched up with a compiled kernel once for the whole grid, not once per cell
+			const GridBits nextGeneration = DispatchRule(rule, [&current, &neighbors](const auto& kernelRule)
+				{
+					return NextGeneration(current, neighbors, kernelRule);
+				});
 
-					gameSim(m_gridBits[swapChain].test(index), numNeighborsSet, alive);
+			//Only the cells inside the padding are ours to write, the padding belongs to our neighbors
+			const GridBits& interiorMask = InteriorMask();
+			GridBits& next = m_gridBits[!swapChain];
+			next = (next & ~interiorMask) | (nextGeneration & interiorMask);
 
-					m_gridBits[!swapChain].set(index, alive);
+			//Original implementations tested a shifted 3x3 pattern (and before that each neighbor individually) against the grid for
+			//every cell, which cost a full bitset scan and a call to the rule function per cell.
+		}
 
-					testPattern = testPattern << 1;
-				}
-				testPattern = testPattern << paddingSize*2;
-			}
+		/// <summary>
+		/// Walk the grid, report locations of bits that are set.
+		/// </summary>
+		/// <param name="fn">The function to run on all the alive cells.</param>
+		void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const
+		{
+			VisitAliveCells(parentCoord, fn);
+		}
 
-			//Original implementation, the above was found to be faster.
-			//Coord placement = { 0,0 };
-			//for (unsigned int x = 0; x < gridSize; ++x)
-			//{
-			//	for (unsigned int y = 0; y < gridSize; ++y)
-			//	{
-			//		Unit index = 0;
-			//		Get1DIndexFromCoord(Coord{ x, y }, gridSizeWithPadding, paddingSize, index);
+		/// <summary>
+		/// Same walk as above, the cells just go into the block instead of through a std::function
+		/// </summary>
+		void CollectCurrentGenerationAliveCells(const Coord& parentCoord, AliveCellBlock& block) const
+		{
+			VisitAliveCells(parentCoord, [&block](const Coord& cell) { block.Push(cell); });
+		}
 
-			//		unsigned int numNeighborsSet =
-			//			m_gridBits[swapChain].test(index - gridSizeWithPadding - 1) +
-			//			m_gridBits[swapChain].test(index - gridSizeWithPadding - 0) +
-			//			m_gridBits[swapChain].test(index - gridSizeWithPadding + 1) +
-			//			m_gridBits[swapChain].test(index - 1) +
-			//			m_gridBits[swapChain].test(index + 1) +
-			//			m_gridBits[swapChain].test(index + gridSizeWithPadding - 1) +
-			//			m_gridBits[swapChain].test(index + gridSizeWithPadding - 0) +
-			//			m_gridBits[swapChain].test(index + gridSizeWithPadding + 1);
+		/// <summary>
+		/// Cells come out of the walk row by row, which is the order the hasher is quickest with
+		/// </summary>
+		UnsignedUnit GetBoardHash() const
+		{
+			BoardHasher hasher;
+			VisitAliveCells(Coord{ 0, 0 }, [&hasher](const Coord& cell) { hasher.Add(cell); });
+			return hasher.Hash();
+		}
 
-			//		bool alive = false;
-			//		gameSim(m_gridBits[swapChain].test(index), numNeighborsSet, alive);
+		/// <summary>
+		/// The grid is only a few words, so counting it is about as cheap as remembering the count would be
+		/// </summary>
+		UnsignedUnit GetPopulation() const
+		{
+			return (m_gridBits[swapChain] & InteriorMask()).count();
+		}
 
-			//		m_gridBits[!swapChain].set(index, alive);
-			//	}
-			//}
+		bool GetBoundingBox(Coord& min, Coord& max) const
+		{
+			BoundsBuilder bounds;
+			VisitAliveCells(Coord{ 0, 0 }, [&bounds](const Coord& cell) { bounds.Add(cell); });
+			return bounds.Get(min, max);
 		}
 
+	private:
 		/// <summary>
-		/// Walk the grid, report locations of bits that are set.
+		/// Pulls the interior of the grid out 64 bits at a time and jumps straight to each set bit with countr_zero, so an empty grid
+		/// costs a couple of word tests rather than a test per cell. Bits come out in index order, so cells still go row by row.
 		/// </summary>
-		/// <param name="fn">The function to run on all the alive cells.</param>
-		void IterateCurrentGenerationAliveCells(const Coord& parentCoord, BoardIteratorFn fn) const
+		template<class CellFn>
+		void VisitAliveCells(const Coord& parentCoord, CellFn&& fn) const
 		{
-			for (unsigned int y = 0; y < gridSize; ++y)
+			const GridBits alive = m_gridBits[swapChain] & InteriorMask();
+			if (alive.none())
 			{
-				for (unsigned int x = 0; x < gridSize; ++x)
+				return;
+			}
+
+			const GridBits lowWord(~0ull);
+			for (int base = 0; base < gridSizeWithPadding1D; base += 64)
+			{
+				uint64_t word = ((alive >> base) & lowWord).to_ullong();
+				while (word != 0)
 				{
-					Coord coord{ x, y };
-					Unit index = 0;
-					Get1DIndexFromCoord(coord, gridSizeWithPadding, paddingSize, index);
-					if (m_gridBits[swapChain].test(index) == true)
-					{
-						fn(Coord{ coord.x + parentCoord.x, coord.y + parentCoord.y });
-					}
+					const int index = base + std::countr_zero(word);
+					word &= word - 1;
+					fn(Coord{ parentCoord.x + (index % gridSizeWithPadding - paddingSize), parentCoord.y + (index / gridSizeWithPadding - paddingSize) });
 				}
 			}
 		}
 
-	private:
 		bool swapChain;
 		GridBits m_gridBits[2];
 	};
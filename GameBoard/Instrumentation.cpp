@@ -0,0 +1,166 @@
+#include "Instrumentation.h"
+#include "GameBoardInterface.h"
+#include <iomanip>
+
+using namespace GameBoard;
+
+const char* Instrumentation::PhaseName(Phase phase)
+{
+	switch (phase)
+	{
+	case Phase::Step:
+		return "Step";
+	case Phase::Halo:
+		return "Halo";
+	case Phase::TileCreate:
+		return "TileCreate";
+	case Phase::TileErase:
+		return "TileErase";
+	case Phase::Retile:
+		return "Retile";
+	case Phase::Io:
+		return "Io";
+	default:
+		return "Unknown";
+	}
+}
+
+#ifdef GOL_INSTRUMENTATION
+namespace
+{
+	struct InstrumentationState
+	{
+		//What's been timed since the last record
+		Instrumentation::PhaseTotals phases[Instrumentation::phaseCount];
+		UnsignedUnit generation = 0;
+
+		//Everything since the last summary. The board sizes are whatever the last record saw.
+		Instrumentation::GenerationRecord summary;
+
+		Instrumentation::GenerationRecordFn recordFn;
+		std::ostream* summaryStream = nullptr;
+		UnsignedUnit summaryInterval = 0;
+	};
+
+	InstrumentationState& State()
+	{
+		static InstrumentationState state;
+		return state;
+	}
+
+	void AddTotals(Instrumentation::PhaseTotals& totals, const Instrumentation::PhaseTotals& other)
+	{
+		totals.nanoseconds += other.nanoseconds;
+		totals.calls += other.calls;
+	}
+}
+
+void Instrumentation::AddPhaseTime(Phase phase, UnsignedUnit nanoseconds)
+{
+	PhaseTotals& totals = State().phases[static_cast<size_t>(phase)];
+	totals.nanoseconds += nanoseconds;
+	++totals.calls;
+}
+
+void Instrumentation::EndGeneration(const IGameBoard& gameBoard, UnsignedUnit generations)
+{
+	InstrumentationState& state = State();
+	state.generation += generations;
+
+	GenerationRecord record;
+	record.generation = state.generation;
+	record.generationsStepped = generations;
+	for (size_t phase = 0; phase < phaseCount; ++phase)
+	{
+		record.phases[phase] = state.phases[phase];
+		state.phases[phase] = PhaseTotals{};
+	}
+
+	//Counting tiles means walking them, so don't bother if nobody's going to look
+	if (!state.recordFn && state.summaryStream == nullptr)
+	{
+		return;
+	}
+
+	gameBoard.IterateTiles([&record](const Coord&, Unit, const IGameBoard&) { ++record.tileCount; });
+	record.liveCells = gameBoard.GetPopulation();
+	record.bytesResident = gameBoard.GetBytesResident();
+
+	if (state.recordFn)
+	{
+		state.recordFn(record);
+	}
+
+	GenerationRecord& summary = state.summary;
+	summary.generation = record.generation;
+	summary.generationsStepped += record.generationsStepped;
+	for (size_t phase = 0; phase < phaseCount; ++phase)
+	{
+		AddTotals(summary.phases[phase], record.phases[phase]);
+	}
+	summary.tileCount = record.tileCount;
+	summary.liveCells = record.liveCells;
+	summary.bytesResident = record.bytesResident;
+
+	if (state.summaryStream != nullptr && summary.generationsStepped >= state.summaryInterval)
+	{
+		PrintSummary(*state.summaryStream);
+	}
+}
+
+void Instrumentation::SetGenerationRecordFn(GenerationRecordFn fn)
+{
+	State().recordFn = std::move(fn);
+}
+
+void Instrumentation::SetSummaryStream(std::ostream* stream, UnsignedUnit interval)
+{
+	State().summaryStream = stream;
+	State().summaryInterval = interval;
+}
+
+void Instrumentation::PrintSummary(std::ostream& stream)
+{
+	GenerationRecord& summary = State().summary;
+
+	UnsignedUnit totalNanoseconds = 0;
+	for (const PhaseTotals& totals : summary.phases)
+	{
+		totalNanoseconds += totals.nanoseconds;
+	}
+
+	const UnsignedUnit generations = std::max(summary.generationsStepped, 1ull);
+	stream << "Generations " << summary.generation - summary.generationsStepped + 1 << " to " << summary.generation
+		<< ": " << summary.liveCells << " live cells, " << summary.tileCount << " tiles, " << summary.bytesResident << " bytes" << std::endl;
+
+	for (size_t phase = 0; phase < phaseCount; ++phase)
+	{
+		const PhaseTotals& totals = summary.phases[phase];
+		if (totals.calls == 0)
+		{
+			continue;
+		}
+
+		const double milliseconds = totals.nanoseconds / 1e6;
+		const double percent = totalNanoseconds == 0 ? 0.0 : 100.0 * totals.nanoseconds / totalNanoseconds;
+		stream << "    " << std::left << std::setw(12) << PhaseName(static_cast<Phase>(phase)) << std::right
+			<< std::fixed << std::setprecision(3) << std::setw(12) << milliseconds << " ms"
+			<< std::setw(10) << milliseconds / generations << " ms/gen"
+			<< std::setprecision(1) << std::setw(7) << percent << "%"
+			<< std::setw(12) << totals.calls << " calls" << std::defaultfloat << std::endl;
+	}
+
+	summary = GenerationRecord{};
+}
+
+void Instrumentation::Reset()
+{
+	InstrumentationState& state = State();
+	for (PhaseTotals& totals : state.phases)
+	{
+		totals = PhaseTotals{};
+	}
+	state.generation = 0;
+	state.summary = GenerationRecord{};
+}
+#endif
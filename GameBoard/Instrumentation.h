@@ -0,0 +1,132 @@
+#pragma once
+#include "GameBoardDefines.h"
+#include <chrono>
+#include <functional>
+#include <ostream>
+
+//Everything in here only does something when GOL_INSTRUMENTATION is defined. Otherwise the hooks are empty inline functions and
+//ScopedPhase is an empty object, so the boards can leave them in their hot paths and normal builds don't read a single clock.
+
+namespace GameBoard
+{
+	class IGameBoard;
+
+	namespace Instrumentation
+	{
+		/// <summary>
+		/// Where a generation's time can go. Step is stepping the cells, the rest is the bookkeeping around it.
+		/// </summary>
+		enum class Phase
+		{
+			Step,
+			Halo,
+			TileCreate,
+			TileErase,
+			Retile,
+			Io,
+			Count
+		};
+		constexpr size_t phaseCount = static_cast<size_t>(Phase::Count);
+
+		const char* PhaseName(Phase phase);
+
+		struct PhaseTotals
+		{
+			UnsignedUnit nanoseconds = 0;
+			UnsignedUnit calls = 0;
+		};
+
+		/// <summary>
+		/// What happened since the last record. Boards that jump ahead (like the hashlife board) make one record for the whole jump,
+		/// everyone else makes one per generation. Anything timed between generations, like loading or printing, lands in the next one.
+		/// </summary>
+		struct GenerationRecord
+		{
+			//Generations finished since the last Reset, including these
+			UnsignedUnit generation = 0;
+			UnsignedUnit generationsStepped = 0;
+
+			PhaseTotals phases[phaseCount];
+
+			//Tiles with live cells in them, 0 for boards that aren't made of tiles
+			UnsignedUnit tileCount = 0;
+			UnsignedUnit liveCells = 0;
+			UnsignedUnit bytesResident = 0;
+		};
+
+		using GenerationRecordFn = std::function<void(const GenerationRecord&)>;
+
+#ifdef GOL_INSTRUMENTATION
+		constexpr bool enabled = true;
+
+		void AddPhaseTime(Phase phase, UnsignedUnit nanoseconds);
+
+		/// <summary>
+		/// Closes off a record for the generations just finished and hands it to whoever is listening. Counting the live cells and tiles
+		/// walks the whole board, so that only happens when there's a record function or a summary stream set.
+		/// </summary>
+		void EndGeneration(const IGameBoard& gameBoard, UnsignedUnit generations);
+
+		/// <summary>
+		/// Gets every record as it's made, or pass an empty function to stop
+		/// </summary>
+		void SetGenerationRecordFn(GenerationRecordFn fn);
+
+		/// <summary>
+		/// Prints a summary to stream every interval generations, or pass nullptr to stop
+		/// </summary>
+		void SetSummaryStream(std::ostream* stream, UnsignedUnit interval);
+
+		/// <summary>
+		/// Prints where the time went since the last summary, and how big the board was at the end of it
+		/// </summary>
+		void PrintSummary(std::ostream& stream);
+
+		/// <summary>
+		/// Throws away everything recorded so far, but keeps the record function and summary stream
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Times a phase from when it's made to when it goes out of scope. Only the thread driving the board should make these, the
+		/// boards that step on several threads time the whole parallel pass from the thread that started it.
+		/// </summary>
+		class ScopedPhase
+		{
+		public:
+			ScopedPhase(Phase phase) : m_phase(phase), m_start(std::chrono::steady_clock::now())
+			{
+
+			}
+
+			~ScopedPhase()
+			{
+				const auto elapsed = std::chrono::steady_clock::now() - m_start;
+				AddPhaseTime(m_phase, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+			}
+
+			ScopedPhase(const ScopedPhase&) = delete;
+			ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+		private:
+			Phase m_phase;
+			std::chrono::steady_clock::time_point m_start;
+		};
+#else
+		constexpr bool enabled = false;
+
+		inline void AddPhaseTime(Phase, UnsignedUnit) {}
+		inline void EndGeneration(const IGameBoard&, UnsignedUnit) {}
+		inline void SetGenerationRecordFn(GenerationRecordFn) {}
+		inline void SetSummaryStream(std::ostream*, UnsignedUnit) {}
+		inline void PrintSummary(std::ostream&) {}
+		inline void Reset() {}
+
+		class ScopedPhase
+		{
+		public:
+			ScopedPhase(Phase) {}
+		};
+#endif
+	}
+}
@@ -0,0 +1,137 @@
+#include "MemoryTracking.h"
+#include <atomic>
+#include <iomanip>
+
+using namespace GameBoard;
+
+namespace
+{
+	struct Counters
+	{
+		std::atomic<UnsignedUnit> liveBytes = 0;
+		std::atomic<UnsignedUnit> peakBytes = 0;
+		std::atomic<UnsignedUnit> allocations = 0;
+		std::atomic<UnsignedUnit> allocatedBytes = 0;
+	};
+
+	//A counter for each subsystem, then one for all of them
+	Counters& GetCounters(size_t index)
+	{
+		static Counters counters[Memory::subsystemCount + 1];
+		return counters[index];
+	}
+
+	Counters& TotalCounters()
+	{
+		return GetCounters(Memory::subsystemCount);
+	}
+
+	void RaisePeak(Counters& counters, UnsignedUnit liveBytes)
+	{
+		UnsignedUnit peak = counters.peakBytes.load(std::memory_order_relaxed);
+		while (liveBytes > peak && !counters.peakBytes.compare_exchange_weak(peak, liveBytes, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void Allocate(Counters& counters, size_t bytes)
+	{
+		const UnsignedUnit liveBytes = counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		counters.allocations.fetch_add(1, std::memory_order_relaxed);
+		counters.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+		RaisePeak(counters, liveBytes);
+	}
+
+	Memory::Usage Read(const Counters& counters)
+	{
+		return Memory::Usage{ counters.liveBytes.load(std::memory_order_relaxed), counters.peakBytes.load(std::memory_order_relaxed),
+			counters.allocations.load(std::memory_order_relaxed), counters.allocatedBytes.load(std::memory_order_relaxed) };
+	}
+}
+
+const char* Memory::SubsystemName(Subsystem subsystem)
+{
+	switch (subsystem)
+	{
+	case Subsystem::Boards:
+		return "Boards";
+	case Subsystem::Tiles:
+		return "Tiles";
+	case Subsystem::NeighborLinks:
+		return "NeighborLinks";
+	case Subsystem::Halo:
+		return "Halo";
+	case Subsystem::Nodes:
+		return "Nodes";
+	case Subsystem::Cells:
+		return "Cells";
+	case Subsystem::Io:
+		return "Io";
+	default:
+		return "Unknown";
+	}
+}
+
+void Memory::RecordAllocation(Subsystem subsystem, size_t bytes)
+{
+	Allocate(GetCounters(static_cast<size_t>(subsystem)), bytes);
+	Allocate(TotalCounters(), bytes);
+}
+
+void Memory::RecordFree(Subsystem subsystem, size_t bytes)
+{
+	GetCounters(static_cast<size_t>(subsystem)).liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+	TotalCounters().liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+Memory::Usage Memory::GetUsage(Subsystem subsystem)
+{
+	return Read(GetCounters(static_cast<size_t>(subsystem)));
+}
+
+Memory::Usage Memory::GetTotalUsage()
+{
+	return Read(TotalCounters());
+}
+
+void Memory::GetUsages(Usage (&usages)[subsystemCount])
+{
+	for (size_t subsystem = 0; subsystem < subsystemCount; ++subsystem)
+	{
+		usages[subsystem] = GetUsage(static_cast<Subsystem>(subsystem));
+	}
+}
+
+void Memory::ResetPeaks()
+{
+	for (size_t index = 0; index <= subsystemCount; ++index)
+	{
+		Counters& counters = GetCounters(index);
+		counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+void Memory::PrintUsage(std::ostream& stream, const Usage (&before)[subsystemCount], UnsignedUnit liveCells)
+{
+	UnsignedUnit liveBytes = 0;
+	for (size_t subsystem = 0; subsystem < subsystemCount; ++subsystem)
+	{
+		const Usage usage = GetUsage(static_cast<Subsystem>(subsystem));
+		liveBytes += usage.liveBytes;
+		if (usage.allocations == before[subsystem].allocations && usage.liveBytes == 0)
+		{
+			continue;
+		}
+
+		stream << "        " << std::left << std::setw(14) << SubsystemName(static_cast<Subsystem>(subsystem)) << std::right
+			<< " live: " << std::setw(10) << usage.liveBytes << " peak: " << std::setw(10) << usage.peakBytes
+			<< " allocations: " << std::setw(8) << usage.allocations - before[subsystem].allocations
+			<< " (" << usage.allocatedBytes - before[subsystem].allocatedBytes << " bytes)" << std::endl;
+	}
+
+	if (liveCells != 0)
+	{
+		stream << "        Bytes per live cell: " << std::fixed << std::setprecision(2) << static_cast<double>(liveBytes) / liveCells
+			<< std::defaultfloat << std::endl;
+	}
+}
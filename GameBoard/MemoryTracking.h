@@ -0,0 +1,143 @@
+#pragma once
+#include "GameBoardDefines.h"
+#include <cstddef>
+#include <new>
+#include <ostream>
+#include <vector>
+
+//Counts what the boards allocate, by what it's for. This is always on: the boards pool and reuse nearly everything once they've warmed
+//up, so there's an atomic add for each of the few allocations left, which is nothing next to the allocation itself.
+
+namespace GameBoard
+{
+	namespace Memory
+	{
+		/// <summary>
+		/// What an allocation is for
+		/// </summary>
+		enum class Subsystem
+		{
+			//Board objects themselves, which for the grid boards includes their cells, so this is where every tile's cells end up
+			Boards,
+			//The multi grid's tile bookkeeping: the slabs tiles are carved from, the free list and the list of tiles in use
+			Tiles,
+			//The hash table tiles find their neighbors through
+			NeighborLinks,
+			//The packed edges and padding tiles trade every generation
+			Halo,
+			//Hashlife nodes and the tables that find them
+			Nodes,
+			//Lists of cells boards keep around, like the simple board's set or scratch space for batches of cells
+			Cells,
+			//Buffers for reading and writing files
+			Io,
+			Count
+		};
+		constexpr size_t subsystemCount = static_cast<size_t>(Subsystem::Count);
+
+		const char* SubsystemName(Subsystem subsystem);
+
+		struct Usage
+		{
+			UnsignedUnit liveBytes = 0;
+			//The most live bytes since the program started or the last ResetPeaks
+			UnsignedUnit peakBytes = 0;
+			//Every allocation ever made, so the difference between two of these is how many were made in between
+			UnsignedUnit allocations = 0;
+			UnsignedUnit allocatedBytes = 0;
+		};
+
+		void RecordAllocation(Subsystem subsystem, size_t bytes);
+		void RecordFree(Subsystem subsystem, size_t bytes);
+
+		Usage GetUsage(Subsystem subsystem);
+
+		/// <summary>
+		/// Everything added up. The peak is the peak of the total, not the sum of each subsystem's peak, since those can happen at different times.
+		/// </summary>
+		Usage GetTotalUsage();
+
+		/// <summary>
+		/// Brings every peak down to what's live right now, so the next peak is only for what happens from here
+		/// </summary>
+		void ResetPeaks();
+
+		/// <summary>
+		/// Prints a line for each subsystem that has had anything allocated since before, and the bytes per live cell if there are any.
+		/// </summary>
+		/// <param name="before">What GetUsage said for each subsystem at the start of whatever is being reported on</param>
+		/// <param name="liveCells">How many cells are alive to share the live bytes between</param>
+		void PrintUsage(std::ostream& stream, const Usage (&before)[subsystemCount], UnsignedUnit liveCells);
+
+		/// <summary>
+		/// GetUsage for every subsystem at once, to hand to PrintUsage later
+		/// </summary>
+		void GetUsages(Usage (&usages)[subsystemCount]);
+
+		/// <summary>
+		/// A standard allocator that counts what it hands out against a subsystem. Containers that hold on to board memory use this so
+		/// it shows up in the numbers on every platform, not just where the debug heap can be asked.
+		/// </summary>
+		template<class T, Subsystem subsystem>
+		class TrackingAllocator
+		{
+		public:
+			using value_type = T;
+
+			template<class U>
+			struct rebind
+			{
+				using other = TrackingAllocator<U, subsystem>;
+			};
+
+			TrackingAllocator() = default;
+
+			template<class U>
+			TrackingAllocator(const TrackingAllocator<U, subsystem>&)
+			{
+
+			}
+
+			T* allocate(size_t count)
+			{
+				RecordAllocation(subsystem, count * sizeof(T));
+				if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+				{
+					return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+				}
+				else
+				{
+					return static_cast<T*>(::operator new(count * sizeof(T)));
+				}
+			}
+
+			void deallocate(T* pointer, size_t count)
+			{
+				RecordFree(subsystem, count * sizeof(T));
+				if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+				{
+					::operator delete(pointer, std::align_val_t(alignof(T)));
+				}
+				else
+				{
+					::operator delete(pointer);
+				}
+			}
+
+			template<class U>
+			bool operator==(const TrackingAllocator<U, subsystem>&) const
+			{
+				return true;
+			}
+
+			template<class U>
+			bool operator!=(const TrackingAllocator<U, subsystem>&) const
+			{
+				return false;
+			}
+		};
+
+		template<class T, Subsystem subsystem>
+		using TrackedVector = std::vector<T, TrackingAllocator<T, subsystem>>;
+	}
+}
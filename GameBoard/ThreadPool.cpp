@@ -0,0 +1,153 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace GameBoard
+{
+	ThreadPool::ThreadPool(unsigned workerCount) : m_job(nullptr), m_jobNumber(0), m_rangesLeft(0), m_stopping(false)
+	{
+		if (workerCount == 0)
+		{
+			workerCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		for (unsigned workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+		{
+			m_queues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		//Worker 0 is whoever calls ParallelFor, so only the rest get threads
+		for (unsigned workerIndex = 1; workerIndex < workerCount; ++workerIndex)
+		{
+			m_threads.emplace_back(&ThreadPool::WorkerLoop, this, workerIndex);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_jobMutex);
+			m_stopping = true;
+		}
+		m_jobStarted.notify_all();
+
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	void ThreadPool::ParallelFor(size_t count, size_t grainSize, const RangeFn& fn)
+	{
+		grainSize = std::max<size_t>(grainSize, 1);
+
+		//Not worth waking anybody up for
+		if (m_threads.empty() || count <= grainSize)
+		{
+			if (count != 0)
+			{
+				fn(0, count);
+			}
+			return;
+		}
+
+		//A few ranges per worker so there's something left to steal when the work is lopsided
+		const size_t rangeCount = std::min((count + grainSize - 1) / grainSize, m_queues.size() * 4);
+		const size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+
+		//The job has to be in place before any range goes in a queue, since a worker still looking for work from the last
+		//loop could pick one up straight away
+		{
+			std::lock_guard<std::mutex> lock(m_jobMutex);
+			m_job = &fn;
+			m_rangesLeft = (count + rangeSize - 1) / rangeSize;
+		}
+
+		size_t queueIndex = 0;
+		for (size_t begin = 0; begin < count; begin += rangeSize)
+		{
+			WorkQueue& queue = *m_queues[queueIndex];
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				queue.ranges.push_back(Range{ begin, std::min(begin + rangeSize, count) });
+			}
+			queueIndex = (queueIndex + 1) % m_queues.size();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_jobMutex);
+			++m_jobNumber;
+		}
+		m_jobStarted.notify_all();
+
+		while (RunOneRange(0))
+		{
+		}
+
+		//Somebody else might still be finishing a range they stole
+		std::unique_lock<std::mutex> lock(m_jobMutex);
+		m_jobFinished.wait(lock, [this]() { return m_rangesLeft == 0; });
+		m_job = nullptr;
+	}
+
+	void ThreadPool::WorkerLoop(unsigned workerIndex)
+	{
+		UnsignedUnit lastJobNumber = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_jobMutex);
+				m_jobStarted.wait(lock, [this, lastJobNumber]() { return m_stopping || m_jobNumber != lastJobNumber; });
+				if (m_stopping)
+				{
+					return;
+				}
+				lastJobNumber = m_jobNumber;
+			}
+
+			while (RunOneRange(workerIndex))
+			{
+			}
+		}
+	}
+
+	bool ThreadPool::RunOneRange(unsigned workerIndex)
+	{
+		const size_t queueCount = m_queues.size();
+		for (size_t offset = 0; offset < queueCount; ++offset)
+		{
+			WorkQueue& queue = *m_queues[(workerIndex + offset) % queueCount];
+
+			Range range;
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (queue.ranges.empty())
+				{
+					continue;
+				}
+
+				//Our own work comes off the back, stolen work off the front, so the two ends don't fight over the same ranges
+				if (offset == 0)
+				{
+					range = queue.ranges.back();
+					queue.ranges.pop_back();
+				}
+				else
+				{
+					range = queue.ranges.front();
+					queue.ranges.pop_front();
+				}
+			}
+
+			(*m_job)(range.begin, range.end);
+
+			if (--m_rangesLeft == 0)
+			{
+				std::lock_guard<std::mutex> lock(m_jobMutex);
+				m_jobFinished.notify_all();
+			}
+			return true;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "GameBoardDefines.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GameBoard
+{
+	/// <summary>
+	/// A small pool of worker threads for splitting up a loop. Each worker has its own queue of ranges to run, and when it runs out it
+	/// steals ranges from the other workers, so a worker that got handed the expensive part of the board doesn't leave everyone else idle.
+	/// The thread that calls ParallelFor pitches in as well, so a pool of N workers only makes N-1 threads.
+	/// </summary>
+	class ThreadPool
+	{
+	public:
+		using RangeFn = std::function<void(size_t begin, size_t end)>;
+
+		/// <summary>
+		/// Starts up the worker threads
+		/// </summary>
+		/// <param name="workerCount">How many threads should work on a loop, counting the caller. 0 means one per hardware thread.</param>
+		explicit ThreadPool(unsigned workerCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		unsigned WorkerCount() const
+		{
+			return static_cast<unsigned>(m_queues.size());
+		}
+
+		/// <summary>
+		/// Runs fn over [0, count) split into ranges across all the workers, and returns when all of them are done. fn must be safe to run
+		/// on different ranges at the same time.
+		/// </summary>
+		/// <param name="count">How many items are in the loop</param>
+		/// <param name="grainSize">The smallest range worth handing to another thread</param>
+		/// <param name="fn">The function to run on each range</param>
+		void ParallelFor(size_t count, size_t grainSize, const RangeFn& fn);
+
+	private:
+		struct Range
+		{
+			size_t begin;
+			size_t end;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Range> ranges;
+		};
+
+		void WorkerLoop(unsigned workerIndex);
+
+		/// <summary>
+		/// Runs one range, taking from the back of our own queue first and then from the front of everyone else's
+		/// </summary>
+		/// <returns>false if there was nothing left to run anywhere</returns>
+		bool RunOneRange(unsigned workerIndex);
+
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+		std::vector<std::thread> m_threads;
+
+		std::mutex m_jobMutex;
+		std::condition_variable m_jobStarted;
+		std::condition_variable m_jobFinished;
+		const RangeFn* m_job;
+		UnsignedUnit m_jobNumber;
+		std::atomic<size_t> m_rangesLeft;
+		bool m_stopping;
+	};
+}
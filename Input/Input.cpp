@@ -1,62 +1,601 @@
 #include "Input.h"
+#include "../GameBoard/GameBoardSnapshot.h"
 #include <iostream>
 #include <fstream>
-#include <regex>
+#include <iterator>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace
 {
-	bool AddCellsFromString(const std::string& input, GameBoard::IGameBoard& gameBoard)
-	{	
-		//Should capture integer values and negative number symbols
-		std::regex number_regex("-?\\d+");
+	//How much of the stream we pull in at a time. Lines get carried over to the next chunk if they're cut off, so this only needs to be
+	//comfortably bigger than a line.
+	constexpr size_t readChunkSize = 1 << 16;
+
+	//How many cells we collect before handing them to the board. Boards sort a batch out by where the cells go, so bigger batches
+	//mean fewer trips to each part of the board.
+	constexpr size_t cellBatchSize = 1 << 16;
+
+	constexpr uint64_t powersOf10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+	bool IsDigit(char character)
+	{
+		return character >= '0' && character <= '9';
+	}
+
+	/// <summary>
+	/// Looks at 8 characters packed into a word at once (first character in the lowest byte) and counts how many digits they start with.
+	/// A byte is a digit if its high nibble is 3 and adding 6 to it doesn't push the low nibble past 9.
+	/// </summary>
+	int CountLeadingDigits(uint64_t characters)
+	{
+		constexpr uint64_t highNibbles = 0xF0F0F0F0F0F0F0F0ull;
+		constexpr uint64_t threes = 0x3030303030303030ull;
+		constexpr uint64_t sixes = 0x0606060606060606ull;
+		constexpr uint64_t lowBits = 0x7F7F7F7F7F7F7F7Full;
+		constexpr uint64_t highBits = 0x8080808080808080ull;
 
-		//Chop up ints from raw input
-		auto numberBegin = std::sregex_iterator(input.begin(), input.end(), number_regex);
+		//Every byte that isn't a digit ends up non zero. Carries out of a non digit can mess up the bytes after it, but we stop at the
+		//first non digit anyway.
+		const uint64_t notDigits = ((characters & highNibbles) ^ threes) | (((characters + sixes) & highNibbles) ^ threes);
 
-		if (numberBegin == std::sregex_iterator())
+		//Sets the top bit of every non zero byte
+		const uint64_t nonZeroBytes = (((notDigits & lowBits) + lowBits) | notDigits) & highBits;
+		return std::countr_zero(nonZeroBytes) / 8;
+	}
+
+	/// <summary>
+	/// Turns up to 8 digit characters packed into a word into their value, by adding neighboring digits together, then neighboring
+	/// pairs, then neighboring groups of 4, rather than going one digit at a time.
+	/// </summary>
+	/// <param name="characters">The characters, first character in the lowest byte</param>
+	/// <param name="digitCount">How many of the characters are digits, from 1 to 8</param>
+	uint64_t ParseDigitWord(uint64_t characters, int digitCount)
+	{
+		//Drop anything past the digits by pushing them to the top. What moves into the bottom is zeros, which read as leading zeros.
+		uint64_t digits = (characters - 0x3030303030303030ull) << (8 * (8 - digitCount));
+		digits = (digits * 10 + (digits >> 8)) & 0x00FF00FF00FF00FFull;
+		digits = (digits * 100 + (digits >> 16)) & 0x0000FFFF0000FFFFull;
+		digits = (digits * 10000 + (digits >> 32)) & 0x00000000FFFFFFFFull;
+		return digits;
+	}
+
+	/// <summary>
+	/// Reads the run of digits at position, 8 at a time while there's room
+	/// </summary>
+	/// <returns>Where the digits stopped</returns>
+	const char* ParseDigits(const char* position, const char* end, uint64_t& value)
+	{
+		value = 0;
+		while (end - position >= 8)
 		{
-			return false;
+			uint64_t characters;
+			std::memcpy(&characters, position, sizeof(characters));
+
+			const int digitCount = CountLeadingDigits(characters);
+			if (digitCount == 0)
+			{
+				return position;
+			}
+
+			value = value * powersOf10[digitCount] + ParseDigitWord(characters, digitCount);
+			position += digitCount;
+
+			if (digitCount < 8)
+			{
+				return position;
+			}
+		}
+
+		for (; position != end && IsDigit(*position); ++position)
+		{
+			value = value * 10 + (*position - '0');
+		}
+		return position;
+	}
+
+	/// <summary>
+	/// Puts the sign on a parsed number. Anything too big for a coordinate gets clamped to the biggest one, the same as atoll does,
+	/// which needs the digits looked at again since the fast path just wraps around.
+	/// </summary>
+	long long ToCoordinate(const char* digitsBegin, const char* digitsEnd, bool negative, uint64_t magnitude)
+	{
+		//18 digits can't overflow
+		constexpr ptrdiff_t safeDigitCount = 18;
+		if (digitsEnd - digitsBegin > safeDigitCount)
+		{
+			const uint64_t limit = negative ? uint64_t(std::numeric_limits<long long>::max()) + 1 : std::numeric_limits<long long>::max();
+			magnitude = 0;
+			for (const char* digit = digitsBegin; digit != digitsEnd; ++digit)
+			{
+				const uint64_t digitValue = *digit - '0';
+				if (magnitude > (limit - digitValue) / 10)
+				{
+					magnitude = limit;
+					break;
+				}
+				magnitude = magnitude * 10 + digitValue;
+			}
+		}
+
+		return static_cast<long long>(negative ? 0 - magnitude : magnitude);
+	}
+
+	/// <summary>
+	/// Reads Life 1.06 a line at a time out of whatever chunks it gets fed. A line is read the same way the old regex version did: every
+	/// integer on it (with an optional minus sign) is taken, and they're paired up into cells. A line with no numbers or an odd number of
+	/// them is malformed and ends the input, though any full pairs before the problem still count.
+	/// </summary>
+	class Life106Reader
+	{
+	public:
+		explicit Life106Reader(GameBoard::IGameBoard& gameBoard) : m_gameBoard(gameBoard), m_firstLine(true)
+		{
+			m_cells.reserve(cellBatchSize);
 		}
 
-		//Grab found ints and take pairs to create cells.
-		for (std::sregex_iterator numberIt = numberBegin; numberIt != std::sregex_iterator(); ++numberIt)
+		/// <summary>
+		/// Reads every whole line in the chunk
+		/// </summary>
+		/// <returns>Where the first line we didn't read starts, or nullptr if we hit malformed input and should stop reading</returns>
+		const char* ReadLines(const char* begin, const char* end)
 		{
-			long long x = atoll(numberIt->str().c_str());
+			const char* lineBegin = begin;
+			while (const char* lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', end - lineBegin)))
+			{
+				if (!ReadLine(lineBegin, lineEnd))
+				{
+					return nullptr;
+				}
+				lineBegin = lineEnd + 1;
+			}
+			return lineBegin;
+		}
 
-			++numberIt;
+		/// <summary>
+		/// Reads the last line, which didn't have a new line after it, and hands over any cells we're still holding on to
+		/// </summary>
+		void Finish(const char* begin, const char* end)
+		{
+			if (begin != end)
+			{
+				ReadLine(begin, end);
+			}
+			FlushCells();
+		}
 
-			//Somehow we cut out halfway between reading integer values, so this is malformed input.
-			if (numberIt == std::sregex_iterator())
+	private:
+		bool ReadLine(const char* begin, const char* end)
+		{
+			if (m_firstLine)
 			{
-				return false;
+				m_firstLine = false;
+
+				std::string_view line(begin, end - begin);
+				if (!line.empty() && line.back() == '\r')
+				{
+					line.remove_suffix(1);
+				}
+
+				//handle header
+				if (line == "#Life 1.06")
+				{
+					return true;
+				}
+			}
+
+			bool foundNumber = false;
+			bool haveX = false;
+			long long x = 0;
+
+			const char* position = begin;
+			while (position != end)
+			{
+				const bool negative = *position == '-' && position + 1 != end && IsDigit(position[1]);
+				if (!negative && !IsDigit(*position))
+				{
+					++position;
+					continue;
+				}
+
+				const char* digitsBegin = position + negative;
+				uint64_t magnitude;
+				position = ParseDigits(digitsBegin, end, magnitude);
+				const long long value = ToCoordinate(digitsBegin, position, negative, magnitude);
+				foundNumber = true;
+
+				if (!haveX)
+				{
+					x = value;
+					haveX = true;
+				}
+				else
+				{
+					AddCell({ x, value });
+					haveX = false;
+				}
+			}
+
+			//Somehow we cut out halfway between reading integer values, or there was nothing here at all, so this is malformed input.
+			return foundNumber && !haveX;
+		}
+
+		void AddCell(const GameBoard::Coord& cell)
+		{
+			m_cells.push_back(cell);
+			if (m_cells.size() == cellBatchSize)
+			{
+				FlushCells();
+			}
+		}
+
+		void FlushCells()
+		{
+			m_gameBoard.SetCells(m_cells, true);
+			m_cells.clear();
+		}
+
+		GameBoard::IGameBoard& m_gameBoard;
+		GameBoard::Memory::TrackedVector<GameBoard::Coord, GameBoard::Memory::Subsystem::Io> m_cells;
+		bool m_firstLine;
+	};
+
+	/// <summary>
+	/// A read only view of a whole file mapped into memory, so the reader can go straight over the OS's own pages without anything
+	/// being copied into a buffer first. The OS is told we'll be reading front to back so it can read ahead and drop pages behind us,
+	/// which matters when the file is bigger than the memory we'd like to spend on it.
+	/// </summary>
+	class MappedFile
+	{
+	public:
+		explicit MappedFile(const std::filesystem::path& filename) : m_data(nullptr), m_size(0)
+		{
+#if defined(_WIN32)
+			m_file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			m_mapping = nullptr;
+			if (m_file == INVALID_HANDLE_VALUE)
+			{
+				return;
+			}
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0)
+			{
+				return;
+			}
+
+			m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (m_mapping == nullptr)
+			{
+				return;
+			}
+
+			m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+			if (m_data != nullptr)
+			{
+				m_size = static_cast<size_t>(fileSize.QuadPart);
+			}
+#else
+			m_file = open(filename.c_str(), O_RDONLY);
+			if (m_file < 0)
+			{
+				return;
+			}
+
+			struct stat fileStats;
+			if (fstat(m_file, &fileStats) != 0 || !S_ISREG(fileStats.st_mode) || fileStats.st_size == 0)
+			{
+				return;
+			}
+
+			void* data = mmap(nullptr, static_cast<size_t>(fileStats.st_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+			if (data == MAP_FAILED)
+			{
+				return;
+			}
+
+			m_data = static_cast<const char*>(data);
+			m_size = static_cast<size_t>(fileStats.st_size);
+			madvise(data, m_size, MADV_SEQUENTIAL);
+#endif
+		}
+
+		~MappedFile()
+		{
+#if defined(_WIN32)
+			if (m_data != nullptr)
+			{
+				UnmapViewOfFile(m_data);
+			}
+			if (m_mapping != nullptr)
+			{
+				CloseHandle(m_mapping);
+			}
+			if (m_file != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(m_file);
+			}
+#else
+			if (m_data != nullptr)
+			{
+				munmap(const_cast<char*>(m_data), m_size);
+			}
+			if (m_file >= 0)
+			{
+				close(m_file);
+			}
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/// <summary>
+		/// If the file could be opened at all. An empty file opens fine but has nothing to map.
+		/// </summary>
+		bool IsOpen() const
+		{
+#if defined(_WIN32)
+			return m_file != INVALID_HANDLE_VALUE;
+#else
+			return m_file >= 0;
+#endif
+		}
+
+		/// <summary>
+		/// If the contents are in memory. Empty files never are, and neither are things like pipes that can't be mapped.
+		/// </summary>
+		bool IsMapped() const
+		{
+			return m_data != nullptr;
+		}
+
+		const char* Begin() const
+		{
+			return m_data;
+		}
+
+		const char* End() const
+		{
+			return m_data + m_size;
+		}
+
+	private:
+#if defined(_WIN32)
+		HANDLE m_file;
+		HANDLE m_mapping;
+#else
+		int m_file;
+#endif
+		const char* m_data;
+		size_t m_size;
+	};
+
+	/// <summary>
+	/// Reads the number at position if there is one, with an optional minus sign
+	/// </summary>
+	/// <returns>Where the number stopped, or position if there wasn't one</returns>
+	const char* ParseSignedNumber(const char* position, const char* end, GameBoard::Unit& value)
+	{
+		while (position != end && (*position == ' ' || *position == '\t'))
+		{
+			++position;
+		}
+
+		const std::from_chars_result result = std::from_chars(position, end, value);
+		return result.ec == std::errc() ? result.ptr : position;
+	}
+
+	/// <summary>
+	/// Reads a whole RLE pattern out of memory. The body is a list of runs with an optional count in front of each: b for dead cells,
+	/// o for live ones and $ for the end of a row, finished off with a !. Live runs go to the board as whole runs, so a board that packs its
+	/// cells into words can fill them without a call per cell.
+	/// 
+	/// RLE doesn't say where a pattern goes, so it starts at 0, 0 unless there's an XLife style #P or #R line with the top left corner.
+	/// The header line's rule is skipped over, the board doesn't know about rules.
+	/// </summary>
+	/// <returns>false if the pattern had something in it that isn't RLE. Any runs read before that are kept.</returns>
+	bool ReadRle(const char* begin, const char* end, GameBoard::IGameBoard& gameBoard)
+	{
+		GameBoard::Coord origin{ 0, 0 };
+
+		//Comments and the header come a line at a time before the body
+		const char* position = begin;
+		while (position != end)
+		{
+			const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', end - position));
+			lineEnd = lineEnd != nullptr ? lineEnd : end;
+
+			const char first = *position;
+			if (first == '#')
+			{
+				if (lineEnd - position > 2 && (position[1] == 'P' || position[1] == 'R'))
+				{
+					GameBoard::Coord corner{ 0, 0 };
+					const char* afterX = ParseSignedNumber(position + 2, lineEnd, corner.x);
+					const char* afterY = ParseSignedNumber(afterX, lineEnd, corner.y);
+					if (afterY != afterX && afterX != position + 2)
+					{
+						origin = corner;
+					}
+				}
+			}
+			else if (first == 'x')
+			{
+				//The header is the last thing before the body
+				position = lineEnd;
+				break;
+			}
+			else if (first != '\r' && first != '\n')
+			{
+				//No header, just straight into the body
+				break;
 			}
 
-			long long y = atoll(numberIt->str().c_str());
+			position = lineEnd != end ? lineEnd + 1 : end;
+		}
+
+		GameBoard::Coord cell = origin;
+		GameBoard::Unit count = 0;
+		for (; position != end; ++position)
+		{
+			const char tag = *position;
+			if (IsDigit(tag))
+			{
+				count = count * 10 + (tag - '0');
+				continue;
+			}
 
-			gameBoard.SetCell({ x, y }, true);
+			const GameBoard::Unit runLength = count != 0 ? count : 1;
+			count = 0;
+
+			if (tag == 'b' || tag == '.')
+			{
+				cell.x += runLength;
+			}
+			else if (tag == '$')
+			{
+				cell.x = origin.x;
+				cell.y += runLength;
+			}
+			else if (tag == '!')
+			{
+				break;
+			}
+			else if ((tag >= 'a' && tag <= 'z') || (tag >= 'A' && tag <= 'Z'))
+			{
+				//o is the live cell, but patterns with more states use other letters and they're all some kind of alive
+				gameBoard.SetCellRun(cell, runLength, true);
+				cell.x += runLength;
+			}
+			else if (tag != ' ' && tag != '\t' && tag != '\r' && tag != '\n')
+			{
+				gameBoard.FinishCurrentGeneration();
+				return false;
+			}
 		}
 
+		//Signal that this version of the board is ready to be read;
+		gameBoard.FinishCurrentGeneration();
 		return true;
 	}
+
+	/// <summary>
+	/// Puts a snapshot back onto a board, a row of a tile at a time. The rows are handed to the board right where they sit in the file,
+	/// so a mapped snapshot never gets copied at all.
+	/// </summary>
+	/// <param name="begin">The start of the snapshot, which has to be 8 byte aligned</param>
+	/// <returns>false if the snapshot was the wrong version or broken. If the header was fine, whatever tiles came before the problem are still on the board.</returns>
+	bool ReadSnapshot(const char* begin, const char* end, GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit& generation, GameBoard::RuleMasks& rule)
+	{
+		assert(reinterpret_cast<uintptr_t>(begin) % alignof(uint64_t) == 0);
+
+		GameBoard::SnapshotHeader header;
+		if (static_cast<size_t>(end - begin) < sizeof(header))
+		{
+			return false;
+		}
+		std::memcpy(&header, begin, sizeof(header));
+
+		//Nobody can run a rule where dead cells with no neighbors come alive, so a B0 rule means the header is garbage
+		if (std::memcmp(header.magic, GameBoard::snapshotMagic, sizeof(header.magic)) != 0 || header.version != GameBoard::snapshotVersion ||
+			(header.birth & 1) != 0)
+		{
+			return false;
+		}
+
+		const char* position = begin + sizeof(header);
+		for (;;)
+		{
+			GameBoard::SnapshotTileHeader tile;
+			if (static_cast<size_t>(end - position) < sizeof(tile))
+			{
+				break;
+			}
+			std::memcpy(&tile, position, sizeof(tile));
+			position += sizeof(tile);
+
+			if (tile.size == 0)
+			{
+				gameBoard.FinishCurrentGeneration();
+				generation = header.generation;
+				rule = GameBoard::RuleMasks{ header.birth, header.survive };
+				return true;
+			}
+
+			const uint64_t rowWords = GameBoard::SnapshotRowWords(tile.size);
+			if (tile.size > GameBoard::snapshotMaximumTileSize || static_cast<uint64_t>(end - position) / sizeof(uint64_t) / rowWords < tile.size)
+			{
+				break;
+			}
+
+			const uint64_t* rows = reinterpret_cast<const uint64_t*>(position);
+			const GameBoard::Unit size = static_cast<GameBoard::Unit>(tile.size);
+			for (GameBoard::Unit row = 0; row < size; ++row)
+			{
+				gameBoard.SetCellRow(GameBoard::Coord{ tile.x, tile.y + row }, size, rows + row * rowWords);
+			}
+			position += tile.size * rowWords * sizeof(uint64_t);
+		}
+
+		//Ran out of file before the end marker
+		gameBoard.FinishCurrentGeneration();
+		return false;
+	}
 }
 
 void Input::CreateGameFromStream(std::istream& stream, GameBoard::IGameBoard& gameBoard)
 {
-	std::string input;
-	std::getline(stream, input);
+	GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+	Life106Reader reader(gameBoard);
 
-	//handle header
-	if (input == "#Life 1.06")
-	{
-		std::getline(stream, input);
-	}
+	//The front of the buffer holds whatever part of a line was left over from the last chunk
+	GameBoard::Memory::TrackedVector<char, GameBoard::Memory::Subsystem::Io> buffer(readChunkSize);
+	size_t carriedOver = 0;
 
-	while (AddCellsFromString(input, gameBoard))
+	while (true)
 	{
-		if (!std::getline(stream, input))
+		//A line longer than the whole buffer needs a bigger buffer
+		if (carriedOver == buffer.size())
 		{
+			buffer.resize(buffer.size() * 2);
+		}
+
+		stream.read(buffer.data() + carriedOver, buffer.size() - carriedOver);
+		const size_t bytesRead = static_cast<size_t>(stream.gcount());
+		const char* end = buffer.data() + carriedOver + bytesRead;
+
+		if (bytesRead == 0)
+		{
+			reader.Finish(buffer.data(), end);
 			break;
 		}
+
+		const char* unread = reader.ReadLines(buffer.data(), end);
+		if (unread == nullptr)
+		{
+			reader.Finish(end, end);
+			break;
+		}
+
+		carriedOver = end - unread;
+		std::memmove(buffer.data(), unread, carriedOver);
 	}
 
 	//Signal that this version of the board is ready to be read;
@@ -70,8 +609,32 @@ void Input::CreateGameFromStdInput(GameBoard::IGameBoard& gameBoard)
 
 bool Input::CreateGameFromFile(std::filesystem::path filename, GameBoard::IGameBoard& gameBoard)
 {
+	{
+		//Only the mapped read is timed here, the stream reader below times itself
+		GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+		MappedFile mappedFile(filename);
+		if (!mappedFile.IsOpen())
+		{
+			return false;
+		}
+
+		//The whole file is one chunk, so all ReadLines can leave behind is a last line with no new line after it
+		if (mappedFile.IsMapped())
+		{
+			Life106Reader reader(gameBoard);
+			const char* unread = reader.ReadLines(mappedFile.Begin(), mappedFile.End());
+			reader.Finish(unread != nullptr ? unread : mappedFile.End(), mappedFile.End());
+
+			//Signal that this version of the board is ready to be read;
+			gameBoard.FinishCurrentGeneration();
+			return true;
+		}
+	}
+
+	//Anything we couldn't map (an empty file, or something like a named pipe) still reads fine as a stream. Binary so nobody spends
+	//time translating line endings, the reader doesn't care about a '\r' at the end of a line.
 	std::fstream fileStream;
-	fileStream.open(filename, std::fstream::in);
+	fileStream.open(filename, std::fstream::in | std::fstream::binary);
 
 	if (!fileStream.is_open())
 	{
@@ -84,3 +647,84 @@ bool Input::CreateGameFromFile(std::filesystem::path filename, GameBoard::IGameB
 
 	return true;
 }
+
+bool Input::CreateGameFromRleStream(std::istream& stream, GameBoard::IGameBoard& gameBoard)
+{
+	GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+	//RLE is small enough that the whole pattern can just be read in
+	const GameBoard::Memory::TrackedVector<char, GameBoard::Memory::Subsystem::Io> contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	return ReadRle(contents.data(), contents.data() + contents.size(), gameBoard);
+}
+
+bool Input::CreateGameFromRleFile(std::filesystem::path filename, GameBoard::IGameBoard& gameBoard)
+{
+	{
+		GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+		MappedFile mappedFile(filename);
+		if (!mappedFile.IsOpen())
+		{
+			return false;
+		}
+
+		if (mappedFile.IsMapped())
+		{
+			return ReadRle(mappedFile.Begin(), mappedFile.End(), gameBoard);
+		}
+	}
+
+	std::fstream fileStream;
+	fileStream.open(filename, std::fstream::in | std::fstream::binary);
+
+	if (!fileStream.is_open())
+	{
+		return false;
+	}
+
+	return CreateGameFromRleStream(fileStream, gameBoard);
+}
+
+bool Input::CreateGameFromSnapshotStream(std::istream& stream, GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit& generation, GameBoard::RuleMasks& rule)
+{
+	GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+	//Read into words so the rows are lined up the same way they would be in a mapping
+	GameBoard::Memory::TrackedVector<uint64_t, GameBoard::Memory::Subsystem::Io> contents;
+	char buffer[1 << 16];
+	size_t size = 0;
+	while (stream.read(buffer, sizeof(buffer)) || stream.gcount() != 0)
+	{
+		const size_t readSize = static_cast<size_t>(stream.gcount());
+		contents.resize((size + readSize + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+		std::memcpy(reinterpret_cast<char*>(contents.data()) + size, buffer, readSize);
+		size += readSize;
+	}
+
+	const char* begin = reinterpret_cast<const char*>(contents.data());
+	return ReadSnapshot(begin, begin + size, gameBoard, generation, rule);
+}
+
+bool Input::CreateGameFromSnapshotFile(std::filesystem::path filename, GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit& generation, GameBoard::RuleMasks& rule)
+{
+	{
+		GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+		MappedFile mappedFile(filename);
+		if (!mappedFile.IsOpen())
+		{
+			return false;
+		}
+
+		if (mappedFile.IsMapped())
+		{
+			return ReadSnapshot(mappedFile.Begin(), mappedFile.End(), gameBoard, generation, rule);
+		}
+	}
+
+	std::fstream fileStream;
+	fileStream.open(filename, std::fstream::in | std::fstream::binary);
+
+	if (!fileStream.is_open())
+	{
+		return false;
+	}
+
+	return CreateGameFromSnapshotStream(fileStream, gameBoard, generation, rule);
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include "..\GameBoard\GameBoardInterface.h"
+#include "../GameBoard/GameBoardInterface.h"
 
 /// <summary>
 /// I decided to allow any gameboard I come up with to be filled out by two methods.
@@ -28,4 +28,42 @@ namespace Input
 	/// <param name="filename">A path to the file we intend to load, either relative to the working directory or a full path.</param>
 	/// <param name="gameBoard">The gameboard we intend to fill out.</param>
 	bool CreateGameFromFile(std::filesystem::path filename, GameBoard::IGameBoard& gameBoard);
+
+	/// <summary>
+	/// Fills out a gameboard with an RLE pattern, the format most patterns online come in. Dense patterns take a fraction of a byte
+	/// per cell this way, where Life 1.06 takes a whole line per cell.
+	/// </summary>
+	/// <param name="stream">Stream to read the pattern from.</param>
+	/// <param name="gameBoard">The gameboard we intend to fill out.</param>
+	/// <returns>false if the pattern was malformed, though whatever was read before the problem is still on the board</returns>
+	bool CreateGameFromRleStream(std::istream& stream, GameBoard::IGameBoard& gameBoard);
+
+	/// <summary>
+	/// Fills out a gameboard with an RLE pattern found in a file.
+	/// </summary>
+	/// <param name="filename">A path to the file we intend to load, either relative to the working directory or a full path.</param>
+	/// <param name="gameBoard">The gameboard we intend to fill out.</param>
+	/// <returns>false if the file couldn't be opened or the pattern was malformed</returns>
+	bool CreateGameFromRleFile(std::filesystem::path filename, GameBoard::IGameBoard& gameBoard);
+
+	/// <summary>
+	/// Puts a board back the way it was when Output::PrintGameBoardToSnapshotStream saved it, tile by tile rather than cell by cell.
+	/// The board doesn't have to be the same kind as the one that was saved, but one with the same tile size gets its tiles filled in whole.
+	/// </summary>
+	/// <param name="stream">Stream to read the snapshot from, which needs to have been opened as binary.</param>
+	/// <param name="gameBoard">The gameboard we intend to fill out.</param>
+	/// <param name="generation">Gets how many generations the board had run when it was saved</param>
+	/// <param name="rule">Gets the rule the board was running when it was saved</param>
+	/// <returns>false if the snapshot was from a different version or broken, in which case generation and rule are left alone</returns>
+	bool CreateGameFromSnapshotStream(std::istream& stream, GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit& generation, GameBoard::RuleMasks& rule);
+
+	/// <summary>
+	/// Restores a snapshot found in a file. The file gets mapped so the tiles go straight from the mapping onto the board.
+	/// </summary>
+	/// <param name="filename">A path to the file we intend to load, either relative to the working directory or a full path.</param>
+	/// <param name="gameBoard">The gameboard we intend to fill out.</param>
+	/// <param name="generation">Gets how many generations the board had run when it was saved</param>
+	/// <param name="rule">Gets the rule the board was running when it was saved</param>
+	/// <returns>false if the file couldn't be opened or the snapshot couldn't be read</returns>
+	bool CreateGameFromSnapshotFile(std::filesystem::path filename, GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit& generation, GameBoard::RuleMasks& rule);
 }
\ No newline at end of file
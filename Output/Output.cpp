@@ -1,39 +1,426 @@
 #include "Output.h"
+#include "../GameBoard/GameBoardSnapshot.h"
+#include "../GameBoard/ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+	/// <summary>
+	/// Writes Life 1.06 into a buffer of its own and only hands it to the stream when it fills up, in one big write. Going through the
+	/// stream a number at a time (and flushing every line with std::endl) was costing a system call per cell.
+	/// </summary>
+	class Life106Writer
+	{
+	public:
+		explicit Life106Writer(std::ostream& stream) : m_stream(stream), m_used(0)
+		{
+			m_buffer.resize(bufferSize);
+		}
+
+		~Life106Writer()
+		{
+			Flush();
+		}
+
+		Life106Writer(const Life106Writer&) = delete;
+		Life106Writer& operator=(const Life106Writer&) = delete;
+
+		void WriteHeader()
+		{
+			constexpr char header[] = "#Life 1.06\n";
+			MakeRoom(sizeof(header));
+			std::copy(header, header + sizeof(header) - 1, m_buffer.data() + m_used);
+			m_used += sizeof(header) - 1;
+		}
+
+		void WriteCell(const GameBoard::Coord& cell)
+		{
+			MakeRoom(maximumCellLength);
+			m_used = FormatCell(m_buffer.data() + m_used, cell) - m_buffer.data();
+		}
+
+		/// <summary>
+		/// Writes a lot of cells at once. Big enough lists get cut into blocks that are formatted on every core at the same time, and
+		/// then written out in order.
+		/// </summary>
+		void WriteCells(const std::vector<GameBoard::Coord>& cells)
+		{
+			GameBoard::ThreadPool& threadPool = FormattingThreadPool();
+			if (cells.size() <= cellsPerBlock || threadPool.WorkerCount() == 1)
+			{
+				for (const GameBoard::Coord& cell : cells)
+				{
+					WriteCell(cell);
+				}
+				return;
+			}
+
+			//Only a few blocks per worker are kept around at a time, so a huge board doesn't need its whole text in memory at once
+			const size_t blocksPerRound = threadPool.WorkerCount() * 2;
+			std::vector<std::vector<char>> blocks(blocksPerRound);
+			std::vector<size_t> blockLengths(blocksPerRound);
+
+			for (size_t roundStart = 0; roundStart < cells.size(); roundStart += blocksPerRound * cellsPerBlock)
+			{
+				const size_t roundBlockCount = std::min(blocksPerRound, (cells.size() - roundStart + cellsPerBlock - 1) / cellsPerBlock);
+				threadPool.ParallelFor(roundBlockCount, 1, [&cells, &blocks, &blockLengths, roundStart](size_t begin, size_t end)
+					{
+						for (size_t block = begin; block < end; ++block)
+						{
+							const size_t blockStart = roundStart + block * cellsPerBlock;
+							const size_t blockEnd = std::min(blockStart + cellsPerBlock, cells.size());
+
+							blocks[block].resize(cellsPerBlock * maximumCellLength);
+							char* position = blocks[block].data();
+							for (size_t cell = blockStart; cell < blockEnd; ++cell)
+							{
+								position = FormatCell(position, cells[cell]);
+							}
+							blockLengths[block] = position - blocks[block].data();
+						}
+					});
+
+				MakeRoom(m_buffer.size());
+				for (size_t block = 0; block < roundBlockCount; ++block)
+				{
+					m_stream.write(blocks[block].data(), blockLengths[block]);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Hands everything so far to the stream, and has the stream push it along too so it shows up before anything written after us
+		/// </summary>
+		void Flush()
+		{
+			if (m_used != 0)
+			{
+				m_stream.write(m_buffer.data(), m_used);
+				m_used = 0;
+			}
+			m_stream.flush();
+		}
+
+	private:
+		static constexpr size_t bufferSize = 1 << 16;
+
+		//Two 20 character numbers (a sign and 19 digits), a space and a new line
+		static constexpr size_t maximumCellLength = 20 * 2 + 2;
+
+		//Enough cells that handing a block to another thread is worth it
+		static constexpr size_t cellsPerBlock = 1 << 14;
+
+		/// <summary>
+		/// Writes a cell's line at position, which needs at least maximumCellLength characters of room
+		/// </summary>
+		/// <returns>Just past the end of the line</returns>
+		static char* FormatCell(char* position, const GameBoard::Coord& cell)
+		{
+			position = std::to_chars(position, position + maximumCellLength, cell.x).ptr;
+			*position++ = ' ';
+			position = std::to_chars(position, position + maximumCellLength, cell.y).ptr;
+			*position++ = '\n';
+			return position;
+		}
+
+		/// <summary>
+		/// Shared by every writer so the threads only get made once, and only if somebody writes enough to need them
+		/// </summary>
+		static GameBoard::ThreadPool& FormattingThreadPool()
+		{
+			static GameBoard::ThreadPool threadPool(0);
+			return threadPool;
+		}
+
+		void MakeRoom(size_t length)
+		{
+			if (m_buffer.size() - m_used < length)
+			{
+				m_stream.write(m_buffer.data(), m_used);
+				m_used = 0;
+			}
+		}
+
+		std::ostream& m_stream;
+		GameBoard::Memory::TrackedVector<char, GameBoard::Memory::Subsystem::Io> m_buffer;
+		size_t m_used;
+	};
+
+	/// <summary>
+	/// Builds up the body of an RLE pattern one run at a time, keeping lines under the 70 characters the format asks for
+	/// </summary>
+	class RleBodyWriter
+	{
+	public:
+		RleBodyWriter() : m_lineLength(0)
+		{
+		}
+
+		void WriteRun(GameBoard::Unit count, char tag)
+		{
+			char run[24];
+			char* runEnd = run;
+			if (count != 1)
+			{
+				runEnd = std::to_chars(run, run + sizeof(run) - 1, count).ptr;
+			}
+			*runEnd++ = tag;
+
+			const size_t runLength = runEnd - run;
+			if (m_lineLength + runLength > maximumLineLength)
+			{
+				m_body.push_back('\n');
+				m_lineLength = 0;
+			}
+			m_body.append(run, runLength);
+			m_lineLength += runLength;
+		}
+
+		const std::string& Body() const
+		{
+			return m_body;
+		}
+
+	private:
+		static constexpr size_t maximumLineLength = 70;
+
+		std::string m_body;
+		size_t m_lineLength;
+	};
+
+	/// <summary>
+	/// Builds a snapshot up in a buffer of words and writes it out a megabyte at a time. Tiles are copied out of the board straight
+	/// into the buffer, so the only copy a tile's cells make on the way to the file is the one the stream makes.
+	/// </summary>
+	class SnapshotWriter
+	{
+	public:
+		explicit SnapshotWriter(std::ostream& stream) : m_stream(stream), m_used(0)
+		{
+			m_buffer.resize(bufferWords);
+		}
+
+		~SnapshotWriter()
+		{
+			Flush();
+		}
+
+		SnapshotWriter(const SnapshotWriter&) = delete;
+		SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+		void WriteHeader(GameBoard::UnsignedUnit generation, const GameBoard::RuleMasks& rule)
+		{
+			GameBoard::SnapshotHeader header = {};
+			std::memcpy(header.magic, GameBoard::snapshotMagic, sizeof(header.magic));
+			header.version = GameBoard::snapshotVersion;
+			header.birth = rule.birth;
+			header.survive = rule.survive;
+			header.generation = generation;
+			Append(&header, sizeof(header));
+		}
+
+		/// <summary>
+		/// Copies a tile out of the board a row at a time. Tiles that turn out to have nothing alive in them (only their padding was set)
+		/// are taken back out again.
+		/// </summary>
+		void WriteTile(const GameBoard::Coord& origin, GameBoard::Unit size, const GameBoard::IGameBoard& tile)
+		{
+			const size_t tileStart = m_used;
+			WriteTileHeader(origin, size);
+
+			const size_t rowWords = GameBoard::SnapshotRowWords(size);
+			uint64_t* rows = Reserve(rowWords * size);
+			for (GameBoard::Unit row = 0; row < size; ++row)
+			{
+				tile.GetCellRow(GameBoard::Coord{ 0, row }, size, rows + row * rowWords);
+			}
+
+			if (std::all_of(rows, rows + rowWords * size, [](uint64_t word) { return word == 0; }))
+			{
+				m_used = tileStart;
+			}
+		}
+
+		/// <summary>
+		/// Writes a tile that's already packed into rows
+		/// </summary>
+		void WriteTile(const GameBoard::Coord& origin, GameBoard::Unit size, const uint64_t* rows)
+		{
+			WriteTileHeader(origin, size);
+			Append(rows, GameBoard::SnapshotRowWords(size) * size * sizeof(uint64_t));
+		}
+
+		void WriteEnd()
+		{
+			WriteTileHeader(GameBoard::Coord{ 0, 0 }, 0);
+		}
+
+		void Flush()
+		{
+			if (m_used != 0)
+			{
+				m_stream.write(reinterpret_cast<const char*>(m_buffer.data()), m_used * sizeof(uint64_t));
+				m_used = 0;
+			}
+			m_stream.flush();
+		}
+
+	private:
+		static constexpr size_t bufferWords = (1 << 20) / sizeof(uint64_t);
+
+		void WriteTileHeader(const GameBoard::Coord& origin, GameBoard::Unit size)
+		{
+			const GameBoard::SnapshotTileHeader header = { origin.x, origin.y, static_cast<uint64_t>(size) };
+			Append(&header, sizeof(header));
+		}
+
+		void Append(const void* data, size_t bytes)
+		{
+			std::memcpy(Reserve(bytes / sizeof(uint64_t)), data, bytes);
+		}
+
+		/// <summary>
+		/// Makes room for count words at the end of the buffer and hands them over. Whatever's already in the buffer gets written first if it
+		/// has to, and a tile too big for the buffer just makes it bigger.
+		/// </summary>
+		uint64_t* Reserve(size_t count)
+		{
+			if (m_buffer.size() - m_used < count)
+			{
+				m_stream.write(reinterpret_cast<const char*>(m_buffer.data()), m_used * sizeof(uint64_t));
+				m_used = 0;
+				if (m_buffer.size() < count)
+				{
+					m_buffer.resize(count);
+				}
+			}
+
+			uint64_t* words = m_buffer.data() + m_used;
+			m_used += count;
+			return words;
+		}
+
+		std::ostream& m_stream;
+		GameBoard::Memory::TrackedVector<uint64_t, GameBoard::Memory::Subsystem::Io> m_buffer;
+		size_t m_used;
+	};
+
+	/// <summary>
+	/// Rounds down rather than towards zero, so negative cells end up in the tile to their left
+	/// </summary>
+	GameBoard::Unit FloorDivide(GameBoard::Unit value, GameBoard::Unit divisor)
+	{
+		const GameBoard::Unit quotient = value / divisor;
+		return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+	}
+}
 
 void Output::PrintGameBoardToStream(std::ostream& stream, const GameBoard::IGameBoard& gameBoard)
 {
+	GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+	Life106Writer writer(stream);
+
 	//Write the header 
-	stream << "#Life 1.06" << std::endl;
+	writer.WriteHeader();
 
 	//Iterate all the live cells and print em out
-	GameBoard::Coord zero{ 0,0 };
-	gameBoard.IterateCurrentGenerationAliveCells(zero, [&stream](const GameBoard::Coord& liveCellCoord)
+	GameBoard::ForEachAliveCell(gameBoard, [&writer](const GameBoard::Coord& liveCellCoord)
 		{
-			stream << liveCellCoord.x << " " << liveCellCoord.y << std::endl;
+			writer.WriteCell(liveCellCoord);
 		});
 }
 
-void PrintGameRectToStream(std::ostream& stream, const GameBoard::Coord& min, const GameBoard::Coord& max, const GameBoard::IGameBoard& gameBoard)
+void Output::PrintGameRectToStream(std::ostream& stream, const GameBoard::Coord& min, const GameBoard::Coord& max, const GameBoard::IGameBoard& gameBoard)
 {
+	GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+	Life106Writer writer(stream);
+
 	//Write the header 
-	stream << "#Life 1.06" << std::endl;
+	writer.WriteHeader();
 
-	//Iterate all the live cells and print em out
-	GameBoard::Coord coordToPrint{ min.x, min.y };
+	//If the rectangle misses every live cell there's nothing to write, and if it holds all of them there's nothing to drop
+	GameBoard::Coord boundsMin;
+	GameBoard::Coord boundsMax;
+	if (!gameBoard.GetBoundingBox(boundsMin, boundsMax) ||
+		boundsMax.x <= min.x || boundsMin.x >= max.x || boundsMax.y <= min.y || boundsMin.y >= max.y)
+	{
+		return;
+	}
+
+	//The board hands the cells over in a stable order, so all that's left is to drop the ones outside the rectangle. This used to check
+	//every cell in the rectangle with GetCell, which got slow fast for big rectangles.
+	std::vector<GameBoard::Coord> cells;
+	gameBoard.GetSortedAliveCells(cells);
 
-	//definitely not the most efficient, but it guarantees a stable order.
-	for (; coordToPrint.y < max.y; ++coordToPrint.y)
+	if (boundsMin.x < min.x || boundsMax.x > max.x || boundsMin.y < min.y || boundsMax.y > max.y)
 	{
-		for (coordToPrint.x = min.x ;coordToPrint.x < max.x; ++coordToPrint.x)
-		{
-			if (gameBoard.GetCell(coordToPrint))
+		cells.erase(std::remove_if(cells.begin(), cells.end(), [&min, &max](const GameBoard::Coord& cell)
 			{
-				stream << coordToPrint.x << " " << coordToPrint.y << std::endl;
-			}
+				return cell.x < min.x || cell.x >= max.x || cell.y < min.y || cell.y >= max.y;
+			}), cells.end());
+	}
+
+	writer.WriteCells(cells);
+}
+
+void Output::PrintGameBoardToRleStream(std::ostream& stream, const GameBoard::IGameBoard& gameBoard)
+{
+	GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+	GameBoard::Coord topLeft;
+	GameBoard::Coord bottomRight;
+	if (!gameBoard.GetBoundingBox(topLeft, bottomRight))
+	{
+		stream << "x = 0, y = 0\n!\n";
+		stream.flush();
+		return;
+	}
+
+	std::vector<GameBoard::Coord> cells;
+	gameBoard.GetSortedAliveCells(cells);
+
+	RleBodyWriter body;
+	GameBoard::Coord position = topLeft;
+	for (size_t cellIndex = 0; cellIndex < cells.size();)
+	{
+		const GameBoard::Coord& cell = cells[cellIndex];
+		if (cell.y != position.y)
+		{
+			body.WriteRun(cell.y - position.y, '$');
+			position = GameBoard::Coord{ topLeft.x, cell.y };
 		}
+
+		if (cell.x != position.x)
+		{
+			body.WriteRun(cell.x - position.x, 'b');
+		}
+
+		//Live cells next to each other on the same row are one run
+		size_t runEnd = cellIndex + 1;
+		while (runEnd < cells.size() && cells[runEnd].y == cell.y && cells[runEnd].x == cell.x + GameBoard::Unit(runEnd - cellIndex))
+		{
+			++runEnd;
+		}
+		body.WriteRun(runEnd - cellIndex, 'o');
+
+		position.x = cell.x + (runEnd - cellIndex);
+		cellIndex = runEnd;
 	}
+	body.WriteRun(1, '!');
+
+	//RLE doesn't say where the pattern goes, so the top left corner goes in an XLife style #R line to get it back in the same place
+	stream << "#R " << topLeft.x << " " << topLeft.y << "\n";
+	stream << "x = " << (bottomRight.x - topLeft.x) << ", y = " << (bottomRight.y - topLeft.y) << "\n";
+	stream.write(body.Body().data(), body.Body().size());
+	stream << "\n";
+	stream.flush();
 }
 
 void Output::PrintGameBoardToStdOutput(const GameBoard::IGameBoard& gameBoard)
@@ -59,4 +446,77 @@ void Output::PrintGameRectToFile(std::filesystem::path filename, const GameBoard
 	PrintGameRectToStream(fileStream, min, max, gameBoard);
 
 	fileStream.close();
-}
\ No newline at end of file
+}
+
+void Output::PrintGameBoardToRleFile(std::filesystem::path filename, const GameBoard::IGameBoard& gameBoard)
+{
+	std::fstream fileStream;
+	fileStream.open(filename, std::fstream::out);
+
+	PrintGameBoardToRleStream(fileStream, gameBoard);
+
+	fileStream.close();
+}
+
+bool Output::PrintGameBoardToSnapshotStream(std::ostream& stream, const GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generation, const GameBoard::RuleMasks& rule)
+{
+	GameBoard::Instrumentation::ScopedPhase ioTimer(GameBoard::Instrumentation::Phase::Io);
+	SnapshotWriter writer(stream);
+	writer.WriteHeader(generation, rule);
+
+	const bool tiled = gameBoard.IterateTiles([&writer](const GameBoard::Coord& origin, GameBoard::Unit size, const GameBoard::IGameBoard& tile)
+		{
+			writer.WriteTile(origin, size, tile);
+		});
+
+	if (!tiled)
+	{
+		//No tiles to copy, so cut the alive cells up into tiles of our own. They come out in row order which is the order the tiles are in.
+		constexpr GameBoard::Unit tileSize = GameBoard::snapshotFallbackTileSize;
+		using Rows = std::array<uint64_t, tileSize * GameBoard::SnapshotRowWords(tileSize)>;
+
+		std::vector<GameBoard::Coord> cells;
+		gameBoard.GetSortedAliveCells(cells);
+
+		std::map<GameBoard::Coord, Rows, GameBoard::LessCoord> tiles;
+		for (const GameBoard::Coord& cell : cells)
+		{
+			const GameBoard::Coord macroCoord{ FloorDivide(cell.x, tileSize), FloorDivide(cell.y, tileSize) };
+			auto [tile, inserted] = tiles.try_emplace(macroCoord);
+			if (inserted)
+			{
+				tile->second.fill(0);
+			}
+
+			const GameBoard::Unit column = cell.x - macroCoord.x * tileSize;
+			const GameBoard::Unit row = cell.y - macroCoord.y * tileSize;
+			tile->second[row * GameBoard::SnapshotRowWords(tileSize) + column / 64] |= 1ull << (column % 64);
+		}
+
+		for (const auto& [macroCoord, rows] : tiles)
+		{
+			writer.WriteTile(GameBoard::Coord{ macroCoord.x * tileSize, macroCoord.y * tileSize }, tileSize, rows.data());
+		}
+	}
+
+	writer.WriteEnd();
+	writer.Flush();
+	return stream.good();
+}
+
+bool Output::PrintGameBoardToSnapshotFile(std::filesystem::path filename, const GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generation, const GameBoard::RuleMasks& rule)
+{
+	std::fstream fileStream;
+	fileStream.open(filename, std::fstream::out | std::fstream::binary | std::fstream::trunc);
+
+	if (!fileStream.is_open())
+	{
+		return false;
+	}
+
+	const bool written = PrintGameBoardToSnapshotStream(fileStream, gameBoard, generation, rule);
+
+	fileStream.close();
+
+	return written && !fileStream.fail();
+}
@@ -4,7 +4,26 @@
 namespace Output
 {
 	void PrintGameBoardToStream(std::ostream& stream, const GameBoard::IGameBoard& gameBoard);
+	void PrintGameRectToStream(std::ostream& stream, const GameBoard::Coord& min, const GameBoard::Coord& max, const GameBoard::IGameBoard& gameBoard);
 	void PrintGameBoardToStdOutput(const GameBoard::IGameBoard& gameBoard);
 	void PrintGameBoardToFile(std::filesystem::path filename, const GameBoard::IGameBoard& gameBoard);
 	void PrintGameRectToFile(std::filesystem::path filename, const GameBoard::Coord& min, const GameBoard::Coord& max, const GameBoard::IGameBoard& gameBoard);
+
+	/// <summary>
+	/// Writes the board as an RLE pattern, which is a lot smaller than Life 1.06 for anything dense. The pattern's top left corner is
+	/// written in a #R line so reading it back with Input::CreateGameFromRleStream puts it in the same place.
+	/// </summary>
+	void PrintGameBoardToRleStream(std::ostream& stream, const GameBoard::IGameBoard& gameBoard);
+	void PrintGameBoardToRleFile(std::filesystem::path filename, const GameBoard::IGameBoard& gameBoard);
+
+	/// <summary>
+	/// Writes a binary snapshot of the board to resume from later with Input::CreateGameFromSnapshotFile. Boards made of tiles have
+	/// each tile copied out as rows of bits, so this is about as quick as writing that much memory to disk gets. Boards don't keep
+	/// track of how many generations they've run or which rule they're running, so those get passed in to be saved alongside.
+	/// </summary>
+	/// <param name="generation">How many generations the board has run</param>
+	/// <param name="rule">The rule the board is running</param>
+	/// <returns>false if anything went wrong writing the snapshot</returns>
+	bool PrintGameBoardToSnapshotStream(std::ostream& stream, const GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generation, const GameBoard::RuleMasks& rule);
+	bool PrintGameBoardToSnapshotFile(std::filesystem::path filename, const GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generation, const GameBoard::RuleMasks& rule);
 }
\ No newline at end of file
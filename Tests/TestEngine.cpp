@@ -2,9 +2,11 @@
 #include "../Game/Game.h"
 #include "../Input/Input.h"
 #include "../Output/Output.h"
+#include <algorithm>
 #include <fstream>
 #include <chrono>
 #include <optional>
+#include <sstream>
 
 namespace
 {
@@ -29,11 +31,11 @@ namespace
 			output << "        Clearing Gameboard" << std::endl;
 			gameBoard.Clear();
 
-#if defined(_DEBUG)
-			_CrtMemState memoryBeforeTest;
-			_CrtMemCheckpoint(&memoryBeforeTest);
-#endif //_DEBUG
+			GameBoard::Memory::Usage memoryBeforeTest[GameBoard::Memory::subsystemCount];
+			GameBoard::Memory::GetUsages(memoryBeforeTest);
+			GameBoard::Memory::ResetPeaks();
 
+			const GameBoard::PoolStats poolStatsBeforeTest = gameBoard.GetPoolStats();
 			const auto timeBeforeTest = std::chrono::high_resolution_clock::now();
 
 			std::string testResult = test(output, suiteName, test.GetName(), gameBoard, min, max) ? "Succeeded" : "Failed";
@@ -43,18 +45,20 @@ namespace
 			const auto timeAfterTest = std::chrono::high_resolution_clock::now();
 
 			std::chrono::duration<float, std::chrono::milliseconds::period> elapsedTime = timeAfterTest - timeBeforeTest;
-			output << "    Elapsed time: " << elapsedTime << std::endl;
+			output << "    Elapsed time: " << elapsedTime.count() << "ms" << std::endl;
 
-#if defined(_DEBUG)
-			_CrtMemState memoryAfterTest;
-			_CrtMemCheckpoint(&memoryAfterTest);
+			//Only boards that pool their sub boards have anything to say here
+			const GameBoard::PoolStats poolStatsAfterTest = gameBoard.GetPoolStats();
+			if (poolStatsAfterTest.hits != 0 || poolStatsAfterTest.misses != 0)
+			{
+				output << "    Sub board pool hits: " << poolStatsAfterTest.hits - poolStatsBeforeTest.hits
+					<< " misses: " << poolStatsAfterTest.misses - poolStatsBeforeTest.misses << std::endl;
+			}
 
-			_CrtMemState difference;
-			_CrtMemDifference(&difference, &memoryBeforeTest, &memoryAfterTest);
-			output << "    Total memory allocated: " << difference.lTotalCount << std::endl;
-			output << "    Maximum memory used at a time (since tests started): " << memoryAfterTest.lHighWaterCount << std::endl;
+			//Peaks are only for this test, allocations are the ones this test made, and live is whatever the board is holding on to now
+			output << "    Memory:" << std::endl;
+			GameBoard::Memory::PrintUsage(output, memoryBeforeTest, gameBoard.GetPopulation());
 			output << "--------------------------------------------" << std::endl;
-#endif //_DEBUG
 		}
 
 		output << "-------------------------------------------------------------------------------------------------" << std::endl;
@@ -66,6 +70,11 @@ void Tests::TestEngine::RunAllTests(std::ostream& output) const
 	RunAliveCellListTests(output);
 	RunStaticGridBoardTests(output);
 	RunMultiGridBoardTests(output);
+	RunSimdGridBoardTests(output);
+	RunHashLifeBoardTests(output);
+	RunAdaptiveGridBoardTests(output);
+	RunPreallocatedGridBoardTests(output);
+	RunRuleTests(output);
 	RunStressBoardTests(output);
 }
 
@@ -74,6 +83,7 @@ void Tests::TestEngine::RunAliveCellListTests(std::ostream& output) const
 	//This board is really just for doing the most basic IO tests
 	GameBoard::IGameBoardPtr simpleGameBoard = GameBoard::CreateSimpleAliveCellListBoard();
 	RunTestSuite(output, *simpleGameBoard, "Basic_IO", std::nullopt, std::nullopt);
+	RunTestSuite(output, *simpleGameBoard, "Tracking", std::nullopt, std::nullopt);
 }
 
 void Tests::TestEngine::RunStaticGridBoardTests(std::ostream& output) const
@@ -89,6 +99,65 @@ void Tests::TestEngine::RunMultiGridBoardTests(std::ostream& output) const
 	GameBoard::IGameBoardPtr multiGridBoard = GameBoard::CreateMultiGridBoard(&GameBoard::CreateStaticGridBoard6);
 	RunTestSuite(output, *multiGridBoard, "8x8_Board", GameBoard::Coord{ 0,0 }, GameBoard::Coord{ 8,8 });
 	RunTestSuite(output, *multiGridBoard, "Big_Board", std::nullopt, std::nullopt);
+	RunTestSuite(output, *multiGridBoard, "Cycles", std::nullopt, std::nullopt);
+	RunTestSuite(output, *multiGridBoard, "Tracking", std::nullopt, std::nullopt);
+
+	//Same again with the sub boards stepped on a few threads, which should make no difference to the answers
+	GameBoard::IGameBoardPtr threadedMultiGridBoard = GameBoard::CreateMultiGridBoard(&GameBoard::CreateStaticGridBoard6, 4);
+	RunTestSuite(output, *threadedMultiGridBoard, "8x8_Board", GameBoard::Coord{ 0,0 }, GameBoard::Coord{ 8,8 });
+	RunTestSuite(output, *threadedMultiGridBoard, "Big_Board", std::nullopt, std::nullopt);
+}
+
+void Tests::TestEngine::RunSimdGridBoardTests(std::ostream& output) const
+{
+	//The SIMD board should give the same answers as the static grid, both on its own and as the sub board of a multi grid.
+	//Big_Board prints in the order the multi grid walks its tiles, which changes with the tile size, so it only gets the 8x8 suite.
+	GameBoard::IGameBoardPtr simdGridBoard = GameBoard::CreateSimdGridBoard();
+	RunTestSuite(output, *simdGridBoard, "8x8_Board", GameBoard::Coord{ 0,0 }, GameBoard::Coord{ 8,8 });
+	RunTestSuite(output, *simdGridBoard, "Cycles", std::nullopt, std::nullopt);
+	RunTestSuite(output, *simdGridBoard, "Tracking", std::nullopt, std::nullopt);
+
+	GameBoard::IGameBoardPtr multiGridBoard = GameBoard::CreateMultiGridBoard(&GameBoard::CreateSimdGridBoard);
+	RunTestSuite(output, *multiGridBoard, "8x8_Board", GameBoard::Coord{ 0,0 }, GameBoard::Coord{ 8,8 });
+}
+
+void Tests::TestEngine::RunHashLifeBoardTests(std::ostream& output) const
+{
+	//The hashlife board walks its cells in quadtree order, so stick to the suites that print a fixed rectangle, plus one that checks its
+	//big jumps against a multi grid going a generation at a time
+	GameBoard::IGameBoardPtr hashLifeBoard = GameBoard::CreateHashLifeBoard();
+	RunTestSuite(output, *hashLifeBoard, "8x8_Board", GameBoard::Coord{ 0,0 }, GameBoard::Coord{ 8,8 });
+	RunTestSuite(output, *hashLifeBoard, "Cycles", std::nullopt, std::nullopt);
+	RunTestSuite(output, *hashLifeBoard, "Jumps", std::nullopt, std::nullopt);
+	RunTestSuite(output, *hashLifeBoard, "Tracking", std::nullopt, std::nullopt);
+}
+
+void Tests::TestEngine::RunAdaptiveGridBoardTests(std::ostream& output) const
+{
+	//The adaptive board changes tile size as it goes, which changes the order the cells come out in, so stick to the suites that
+	//print a fixed rectangle, plus one that compares it against a plain multi grid while it moves between tile sizes
+	GameBoard::IGameBoardPtr adaptiveGridBoard = GameBoard::CreateAdaptiveGridBoard();
+	RunTestSuite(output, *adaptiveGridBoard, "8x8_Board", GameBoard::Coord{ 0,0 }, GameBoard::Coord{ 8,8 });
+	RunTestSuite(output, *adaptiveGridBoard, "Adaptive", std::nullopt, std::nullopt);
+	RunTestSuite(output, *adaptiveGridBoard, "Cycles", std::nullopt, std::nullopt);
+	RunTestSuite(output, *adaptiveGridBoard, "Tracking", std::nullopt, std::nullopt);
+}
+
+void Tests::TestEngine::RunPreallocatedGridBoardTests(std::ostream& output) const
+{
+	//Made for everything from -32 to 32 over 200 generations, which is more than room enough for every suite that gets run on it
+	GameBoard::IGameBoardPtr preallocatedGridBoard = GameBoard::CreatePreallocatedGridBoard(GameBoard::Coord{ -32, -32 }, GameBoard::Coord{ 32, 32 }, 200);
+	RunTestSuite(output, *preallocatedGridBoard, "8x8_Board", GameBoard::Coord{ 0,0 }, GameBoard::Coord{ 8,8 });
+	RunTestSuite(output, *preallocatedGridBoard, "Cycles", std::nullopt, std::nullopt);
+	RunTestSuite(output, *preallocatedGridBoard, "Tracking", std::nullopt, std::nullopt);
+	RunTestSuite(output, *preallocatedGridBoard, "Preallocated", std::nullopt, std::nullopt);
+}
+
+void Tests::TestEngine::RunRuleTests(std::ostream& output) const
+{
+	//Rules other than Conway's go through their own kernels, so run them on a board that crosses sub board edges
+	GameBoard::IGameBoardPtr multiGridBoard = GameBoard::CreateMultiGridBoard(&GameBoard::CreateStaticGridBoard6);
+	RunTestSuite(output, *multiGridBoard, "Rules", std::nullopt, std::nullopt);
 }
 
 void Tests::TestEngine::RunStressBoardTests(std::ostream& output) const
@@ -182,6 +251,74 @@ namespace
 
 		return true;
 	}
+
+	/// <summary>
+	/// Saves the board to a snapshot file next to the test data, clears it and restores it from the file again, checking the generation
+	/// and rule come back with it
+	/// </summary>
+	bool SnapshotAndRestore(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, GameBoard::UnsignedUnit generation)
+	{
+		output << "        Writing and restoring snapshot" << std::endl;
+		std::filesystem::path localPathToSnapshot = "testdata";
+		localPathToSnapshot.append(suiteName);
+		localPathToSnapshot.append(testName);
+		localPathToSnapshot.append("output.snapshot");
+
+		if (!Output::PrintGameBoardToSnapshotFile(localPathToSnapshot, gameBoard, generation, Game::GameOfLifeRule()))
+		{
+			output << "        Couldn't write the snapshot" << std::endl;
+			return false;
+		}
+
+		gameBoard.Clear();
+
+		GameBoard::UnsignedUnit restoredGeneration = 0;
+		GameBoard::RuleMasks restoredRule;
+		if (!Input::CreateGameFromSnapshotFile(localPathToSnapshot, gameBoard, restoredGeneration, restoredRule))
+		{
+			output << "        Couldn't read back the snapshot we wrote" << std::endl;
+			return false;
+		}
+
+		if (restoredGeneration != generation || restoredRule != Game::GameOfLifeRule())
+		{
+			output << "        Snapshot came back with the wrong generation or rule" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// A size x size square of random cells with its top left corner at (offset, offset). Uses its own generator rather than anything in
+	/// <random> so the soup is the same on every compiler.
+	/// </summary>
+	std::vector<GameBoard::Coord> MakeSoup(GameBoard::Unit size, unsigned densityPercent, uint64_t seed, GameBoard::Unit offset)
+	{
+		std::vector<GameBoard::Coord> cells;
+		uint64_t random = seed;
+		for (GameBoard::Unit y = 0; y < size; ++y)
+		{
+			for (GameBoard::Unit x = 0; x < size; ++x)
+			{
+				random = random * 6364136223846793005ull + 1442695040888963407ull;
+				if ((random >> 33) % 100 < densityPercent)
+				{
+					cells.push_back({ offset + x, offset + y });
+				}
+			}
+		}
+		return cells;
+	}
+
+	/// <summary>
+	/// True if both lists have the same cells in the same order, which for GetSortedAliveCells means the boards match
+	/// </summary>
+	bool SameCells(const std::vector<GameBoard::Coord>& lhs, const std::vector<GameBoard::Coord>& rhs)
+	{
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+			[](const GameBoard::Coord& a, const GameBoard::Coord& b) { return a.x == b.x && a.y == b.y; });
+	}
 }
 
 //This is a simple style of test that assumes there is a file at a location specified by the test suite and name
@@ -196,6 +333,94 @@ bool LoadAndDiffFromDiskTest(std::ostream& output, const std::string& suiteName,
 	return DiffFromDisk(output, suiteName, testName, gameBoard, min, max);
 }
 
+//Loads an RLE pattern and checks it against a Life 1.06 diff, then writes it back out as RLE and makes sure reading that gives the
+//same RLE again, so the reader and writer agree with each other
+bool LoadRleAndDiffFromDiskTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	output << "        Loading test data" << std::endl;
+
+	std::filesystem::path localPathToTestData = "testdata";
+	localPathToTestData.append(suiteName);
+	localPathToTestData.append(testName);
+	localPathToTestData.append("input.rle");
+
+	if (!Input::CreateGameFromRleFile(localPathToTestData, gameBoard))
+	{
+		output << "        Test data at " << suiteName << "\\" << testName << " failed to load." << std::endl;
+		return false;
+	}
+
+	if (!DiffFromDisk(output, suiteName, testName, gameBoard, min, max))
+	{
+		return false;
+	}
+
+	output << "        Writing and reading back RLE" << std::endl;
+	std::stringstream firstRle;
+	Output::PrintGameBoardToRleStream(firstRle, gameBoard);
+
+	gameBoard.Clear();
+	if (!Input::CreateGameFromRleStream(firstRle, gameBoard))
+	{
+		output << "        Couldn't read back the RLE we wrote" << std::endl;
+		return false;
+	}
+
+	std::stringstream secondRle;
+	Output::PrintGameBoardToRleStream(secondRle, gameBoard);
+	if (firstRle.str() != secondRle.str())
+	{
+		output << "        RLE changed after reading it back" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+//Every input file under testdata should come out the same whether it gets memory mapped or read as a stream
+bool MappedFileMatchesStreamTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	auto collectAliveCells = [&gameBoard]()
+	{
+		std::vector<std::pair<GameBoard::Unit, GameBoard::Unit>> cells;
+		GameBoard::ForEachAliveCell(gameBoard, [&cells](const GameBoard::Coord& cell) { cells.emplace_back(cell.x, cell.y); });
+		std::sort(cells.begin(), cells.end());
+		return cells;
+	};
+
+	bool passed = true;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator("testdata"))
+	{
+		if (entry.path().filename() != "input.life")
+		{
+			continue;
+		}
+
+		gameBoard.Clear();
+		if (!Input::CreateGameFromFile(entry.path(), gameBoard))
+		{
+			output << "        Couldn't load " << entry.path().string() << std::endl;
+			passed = false;
+			continue;
+		}
+		const auto mappedCells = collectAliveCells();
+
+		gameBoard.Clear();
+		std::fstream fileStream;
+		fileStream.open(entry.path(), std::fstream::in);
+		Input::CreateGameFromStream(fileStream, gameBoard);
+		const auto streamedCells = collectAliveCells();
+
+		if (mappedCells != streamedCells)
+		{
+			output << "        " << entry.path().string() << " loaded differently from a stream" << std::endl;
+			passed = false;
+		}
+	}
+
+	return passed;
+}
+
 //Actually runs one generation of the game of life
 bool LoadAndRun1GenerationAndDiffFromDiskTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
 {
@@ -219,10 +444,11 @@ bool LoadAndRun15GenerationAndDiffFromDiskTest(std::ostream& output, const std::
 		return false;
 	}
 
-	for (int i = 0; i < 15; ++i)
+	output << "        Running 15 generations" << std::endl;
+	const Game::CycleRunResult result = Game::RunGameOfLifeGenerationsDetectingCycles(gameBoard, 15);
+	if (result.period != 0)
 	{
-		output << "        Running generation " << i << std::endl;
-		Game::RunGameOfLifeGeneration(gameBoard);
+		output << "        Settled into period " << result.period << " after " << result.generationsStepped << " generations" << std::endl;
 	}
 
 	return DiffFromDisk(output, suiteName, testName, gameBoard, min, max);
@@ -236,20 +462,61 @@ bool LoadAndRun100GenerationAndDiffFromDiskTest(std::ostream& output, const std:
 		return false;
 	}
 
-	for (int i = 0; i < 100; ++i)
+	Game::RunGameOfLifeGenerations(gameBoard, 100);
+
+	return DiffFromDisk(output, suiteName, testName, gameBoard, min, max);
+}
+
+//Runs a generation, snapshots the board and restores it, then checks the restored board against the diff
+bool LoadAndRun1GenerationThroughSnapshotAndDiffFromDiskTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	if (!LoadTestDataFromName(output, suiteName, testName, gameBoard))
 	{
-		Game::RunGameOfLifeGeneration(gameBoard);
+		output << "        Test data at " << suiteName << "\\" << testName << " failed to load." << std::endl;
+		return false;
+	}
+
+	output << "        Running generation 1" << std::endl;
+	Game::RunGameOfLifeGeneration(gameBoard);
+
+	if (!SnapshotAndRestore(output, suiteName, testName, gameBoard, 1))
+	{
+		return false;
+	}
+
+	return DiffFromDisk(output, suiteName, testName, gameBoard, min, max);
+}
+
+//Snapshots halfway through 100 generations, so the second half has to carry on from a restored board as if nothing happened
+bool LoadAndRun100GenerationsThroughSnapshotAndDiffFromDiskTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	if (!LoadTestDataFromName(output, suiteName, testName, gameBoard))
+	{
+		output << "        Test data at " << suiteName << "\\" << testName << " failed to load." << std::endl;
+		return false;
 	}
 
+	Game::RunGameOfLifeGenerations(gameBoard, 50);
+
+	if (!SnapshotAndRestore(output, suiteName, testName, gameBoard, 50))
+	{
+		return false;
+	}
+
+	Game::RunGameOfLifeGenerations(gameBoard, 50);
+
 	return DiffFromDisk(output, suiteName, testName, gameBoard, min, max);
 }
 
 bool MakeTheLineTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
 {
+	std::vector<GameBoard::Coord> line;
+	line.reserve(1000000);
 	for (long long i = 0; i < 1000000; ++i)
 	{
-		gameBoard.SetCell({i,i}, true);
+		line.push_back({i,i});
 	}
+	gameBoard.SetCells(line, true);
 	gameBoard.FinishCurrentGeneration();
 
 	for (int i = 0; i < 100; ++i)
@@ -260,18 +527,360 @@ bool MakeTheLineTest(std::ostream& output, const std::string& suiteName, const s
 	return DiffFromDisk(output, suiteName, testName, gameBoard, min, max);
 }
 
+//A dense soup that burns down to ash while a glider flies off on its own, which should push an adaptive board from big tiles to small
+//ones partway through. Whatever tiles the board is on, it has to agree with a multi grid that never changes.
+bool SoupMatchesMultiGridTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	GameBoard::IGameBoardPtr referenceBoard = GameBoard::CreateMultiGridBoard(&GameBoard::CreateSimdGridBoard);
+
+	std::vector<GameBoard::Coord> cells = MakeSoup(600, 35, 12345, 0);
+	const GameBoard::Coord glider[] = { { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 } };
+	for (const GameBoard::Coord& cell : glider)
+	{
+		cells.push_back({ cell.x + 5000, cell.y - 5000 });
+	}
+
+	gameBoard.SetCells(cells, true);
+	gameBoard.FinishCurrentGeneration();
+	referenceBoard->SetCells(cells, true);
+	referenceBoard->FinishCurrentGeneration();
+
+	std::vector<GameBoard::Coord> aliveCells;
+	std::vector<GameBoard::Coord> referenceCells;
+	for (int generation = 1; generation <= 300; ++generation)
+	{
+		Game::RunGameOfLifeGeneration(gameBoard);
+		Game::RunGameOfLifeGeneration(*referenceBoard);
+
+		if (generation % 50 == 0)
+		{
+			gameBoard.GetSortedAliveCells(aliveCells);
+			referenceBoard->GetSortedAliveCells(referenceCells);
+			if (!SameCells(aliveCells, referenceCells))
+			{
+				output << "        Generation " << generation << " has " << aliveCells.size() << " cells, expected " << referenceCells.size() << std::endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+//Checks rulestrings read into the masks we expect, and that the ones that make no sense get turned away
+bool ParseRuleTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	struct RuleCase
+	{
+		const char* ruleString;
+		bool valid;
+		GameBoard::RuleMasks rule;
+	};
+
+	const RuleCase ruleCases[] =
+	{
+		{ "B3/S23", true, Game::GameOfLifeRule() },
+		{ "b3/s23", true, Game::GameOfLifeRule() },
+		{ "S23/B3", true, Game::GameOfLifeRule() },
+		{ "23/3", true, Game::GameOfLifeRule() },
+		{ "B36/S23", true, { (1 << 3) | (1 << 6), (1 << 2) | (1 << 3) } },
+		{ "B2/S", true, { 1 << 2, 0 } },
+		{ "B/S012345678", true, { 0, 0x1ff } },
+		{ "B3S23", false, {} },
+		{ "B3/S29", false, {} },
+		{ "B3/B3", false, {} },
+		{ "B03/S23", false, {} },
+		{ "", false, {} },
+	};
+
+	bool passed = true;
+	for (const RuleCase& ruleCase : ruleCases)
+	{
+		GameBoard::RuleMasks rule;
+		const bool valid = Game::ParseRule(ruleCase.ruleString, rule);
+		if (valid != ruleCase.valid || (valid && rule != ruleCase.rule))
+		{
+			output << "        Rule \"" << ruleCase.ruleString << "\" didn't parse as expected" << std::endl;
+			passed = false;
+		}
+	}
+
+	return passed;
+}
+
+//HighLife (B36/S23) has a replicator that copies itself every 12 generations, which Conway's rule would never do
+bool LoadAndRun12HighLifeGenerationsAndDiffFromDiskTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	if (!LoadTestDataFromName(output, suiteName, testName, gameBoard))
+	{
+		output << "        Test data at " << suiteName << "\\" << testName << " failed to load." << std::endl;
+		return false;
+	}
+
+	GameBoard::RuleMasks highLife;
+	Game::ParseRule("B36/S23", highLife);
+	Game::RunGenerations(gameBoard, highLife, 12);
+
+	return DiffFromDisk(output, suiteName, testName, gameBoard, min, max);
+}
+
+//A block, a blinker and a row of 10 that turns straight into a pentadecathlon, so the whole board repeats every 30 generations. Asking for
+//a billion generations should only step a few dozen, land on the same phase a reference board gets to by running the long way, and the
+//board hash has to be the same as hashing the cells by hand no matter how the board stores them.
+bool OscillatorsSkipToGenerationTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	std::vector<GameBoard::Coord> cells = { { 50, 50 }, { 51, 50 }, { 50, 51 }, { 51, 51 }, { 5, 5 }, { 6, 5 }, { 7, 5 } };
+	for (GameBoard::Unit x = 20; x < 30; ++x)
+	{
+		cells.push_back({ x, 30 });
+	}
+
+	gameBoard.SetCells(cells, true);
+	gameBoard.FinishCurrentGeneration();
+
+	GameBoard::IGameBoardPtr referenceBoard = GameBoard::CreateSimdGridBoard();
+	referenceBoard->SetCells(cells, true);
+	referenceBoard->FinishCurrentGeneration();
+
+	const GameBoard::UnsignedUnit generations = 1000000007;
+	const Game::CycleRunResult result = Game::RunGameOfLifeGenerationsDetectingCycles(gameBoard, generations);
+	output << "        Settled into period " << result.period << " after " << result.generationsStepped << " generations" << std::endl;
+	if (result.period != 30 || result.generationsStepped > 200)
+	{
+		output << "        Expected period 30 within 200 generations" << std::endl;
+		return false;
+	}
+
+	//Enough generations for the reference to settle too, in the same phase of the cycle
+	Game::RunGameOfLifeGenerations(*referenceBoard, 120 + generations % 30);
+
+	std::vector<GameBoard::Coord> aliveCells;
+	std::vector<GameBoard::Coord> referenceCells;
+	gameBoard.GetSortedAliveCells(aliveCells);
+	referenceBoard->GetSortedAliveCells(referenceCells);
+	if (!SameCells(aliveCells, referenceCells))
+	{
+		output << "        Board has " << aliveCells.size() << " cells, expected " << referenceCells.size() << std::endl;
+		return false;
+	}
+
+	GameBoard::BoardHasher hasher;
+	for (const GameBoard::Coord& cell : aliveCells)
+	{
+		hasher.Add(cell);
+	}
+	if (gameBoard.GetBoardHash() != hasher.Hash() || referenceBoard->GetBoardHash() != hasher.Hash())
+	{
+		output << "        Board hash doesn't match hashing the cells one at a time" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+//Hashlife only earns its keep jumping through lots of generations at once, so those jumps have to land where a board stepping one
+//generation at a time does. An R-pentomino runs until it settles, a glider jumps a billion generations and has to have moved exactly
+//a quarter of that, and gliders and a block out past 2^62 each way have to survive being stepped at the edges of the space.
+bool JumpsMatchMultiGridTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	const std::vector<GameBoard::Coord> rPentomino = { { 1, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 }, { 1, 2 } };
+	const std::vector<GameBoard::Coord> glider = { { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 } };
+	const GameBoard::Unit far = GameBoard::Unit(1) << 62;
+
+	std::vector<GameBoard::Coord> farCells = { { -far - 20, far + 20 }, { -far - 19, far + 20 }, { -far - 20, far + 21 }, { -far - 19, far + 21 } };
+	for (const GameBoard::Coord& cell : glider)
+	{
+		farCells.push_back({ cell.x + far, cell.y + far });
+		farCells.push_back({ cell.x - far - 1, cell.y - far - 1 });
+	}
+
+	auto matchesReference = [&output, &gameBoard](const char* name, const std::vector<GameBoard::Coord>& cells, GameBoard::UnsignedUnit generations)
+		{
+			GameBoard::IGameBoardPtr referenceBoard = GameBoard::CreateMultiGridBoard(&GameBoard::CreateSimdGridBoard);
+			gameBoard.Clear();
+			gameBoard.SetCells(cells, true);
+			gameBoard.FinishCurrentGeneration();
+			referenceBoard->SetCells(cells, true);
+			referenceBoard->FinishCurrentGeneration();
+
+			Game::RunGameOfLifeGenerations(gameBoard, generations);
+			Game::RunGameOfLifeGenerations(*referenceBoard, generations);
+
+			std::vector<GameBoard::Coord> aliveCells;
+			std::vector<GameBoard::Coord> referenceCells;
+			gameBoard.GetSortedAliveCells(aliveCells);
+			referenceBoard->GetSortedAliveCells(referenceCells);
+			if (!SameCells(aliveCells, referenceCells))
+			{
+				output << "        " << name << " has " << aliveCells.size() << " cells after " << generations << " generations, expected " << referenceCells.size() << std::endl;
+				return false;
+			}
+			return true;
+		};
+
+	if (!matchesReference("R-pentomino", rPentomino, 1103) || !matchesReference("Far cells", farCells, 1) || !matchesReference("Far cells", farCells, 100))
+	{
+		return false;
+	}
+
+	const GameBoard::UnsignedUnit generations = 1000000000;
+	gameBoard.Clear();
+	gameBoard.SetCells(glider, true);
+	gameBoard.FinishCurrentGeneration();
+	Game::RunGameOfLifeGenerations(gameBoard, generations);
+
+	std::vector<GameBoard::Coord> expectedCells;
+	for (const GameBoard::Coord& cell : glider)
+	{
+		expectedCells.push_back({ cell.x + static_cast<GameBoard::Unit>(generations / 4), cell.y + static_cast<GameBoard::Unit>(generations / 4) });
+	}
+	std::sort(expectedCells.begin(), expectedCells.end(), GameBoard::LessCoord());
+
+	std::vector<GameBoard::Coord> aliveCells;
+	gameBoard.GetSortedAliveCells(aliveCells);
+	if (!SameCells(aliveCells, expectedCells))
+	{
+		output << "        Glider didn't end up a quarter of a billion cells away after a billion generations" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+//The population and bounding box every board keeps as it goes have to match counting the cells by hand, as a soup sitting across the
+//origin burns down and as cells get taken off the edges of it
+bool PopulationAndBoundsMatchCellsTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	std::vector<GameBoard::Coord> cells = MakeSoup(48, 40, 777, -24);
+	gameBoard.SetCells(cells, true);
+	gameBoard.FinishCurrentGeneration();
+
+	auto matchesCells = [&output, &gameBoard](int generation)
+		{
+			GameBoard::UnsignedUnit population = 0;
+			GameBoard::BoundsBuilder bounds;
+			GameBoard::ForEachAliveCell(gameBoard, [&population, &bounds](const GameBoard::Coord& cell)
+				{
+					++population;
+					bounds.Add(cell);
+				});
+
+			GameBoard::Coord expectedMin{ 0, 0 };
+			GameBoard::Coord expectedMax{ 0, 0 };
+			GameBoard::Coord boardMin{ 0, 0 };
+			GameBoard::Coord boardMax{ 0, 0 };
+			const bool expectedAny = bounds.Get(expectedMin, expectedMax);
+			const bool boardAny = gameBoard.GetBoundingBox(boardMin, boardMax);
+			if (gameBoard.GetPopulation() != population || expectedAny != boardAny || (expectedAny &&
+				(boardMin.x != expectedMin.x || boardMin.y != expectedMin.y || boardMax.x != expectedMax.x || boardMax.y != expectedMax.y)))
+			{
+				output << "        Generation " << generation << " has " << gameBoard.GetPopulation() << " cells in (" << boardMin.x << ", " << boardMin.y
+					<< ") to (" << boardMax.x << ", " << boardMax.y << "), expected " << population << " in (" << expectedMin.x << ", " << expectedMin.y
+					<< ") to (" << expectedMax.x << ", " << expectedMax.y << ")" << std::endl;
+				return false;
+			}
+			return true;
+		};
+
+	for (int generation = 0; generation < 60; ++generation)
+	{
+		if (!matchesCells(generation))
+		{
+			return false;
+		}
+		Game::RunGameOfLifeGeneration(gameBoard);
+	}
+
+	//Take off the top and left edges a row and column at a time, which is what pulls the box in. Cells can only be set on a board whose
+	//buffers agree, so the board gets loaded again with what's left each time.
+	for (int cut = 0; cut < 20; ++cut)
+	{
+		GameBoard::Coord boardMin{ 0, 0 };
+		GameBoard::Coord boardMax{ 0, 0 };
+		if (!gameBoard.GetBoundingBox(boardMin, boardMax))
+		{
+			break;
+		}
+
+		std::vector<GameBoard::Coord> remaining;
+		GameBoard::ForEachAliveCell(gameBoard, [&remaining, &boardMin](const GameBoard::Coord& cell)
+			{
+				if (cell.x != boardMin.x && cell.y != boardMin.y)
+				{
+					remaining.push_back(cell);
+				}
+			});
+		gameBoard.Clear();
+		gameBoard.SetCells(remaining, true);
+		gameBoard.FinishCurrentGeneration();
+
+		if (!matchesCells(60 + cut))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//The preallocated board is made for a soup from -32 to 32 and 200 generations, so for all 200 of them nothing the soup throws off can reach
+//the edge of the plane and it has to agree with a board that goes on forever. Asking for the same board with too little memory gets nothing.
+bool BoundedSoupMatchesMultiGridTest(std::ostream& output, const std::string& suiteName, const std::string& testName, GameBoard::IGameBoard& gameBoard, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max)
+{
+	if (GameBoard::CreatePreallocatedGridBoard(GameBoard::Coord{ -32, -32 }, GameBoard::Coord{ 32, 32 }, 200, 1024))
+	{
+		output << "        Made a board bigger than the memory it was given" << std::endl;
+		return false;
+	}
+
+	GameBoard::IGameBoardPtr referenceBoard = GameBoard::CreateMultiGridBoard(&GameBoard::CreateSimdGridBoard);
+
+	std::vector<GameBoard::Coord> cells = MakeSoup(64, 40, 4242, -32);
+
+	gameBoard.SetCells(cells, true);
+	gameBoard.FinishCurrentGeneration();
+	referenceBoard->SetCells(cells, true);
+	referenceBoard->FinishCurrentGeneration();
+
+	std::vector<GameBoard::Coord> aliveCells;
+	std::vector<GameBoard::Coord> referenceCells;
+	for (int generation = 1; generation <= 200; ++generation)
+	{
+		Game::RunGameOfLifeGeneration(gameBoard);
+		Game::RunGameOfLifeGeneration(*referenceBoard);
+
+		if (generation % 50 == 0)
+		{
+			gameBoard.GetSortedAliveCells(aliveCells);
+			referenceBoard->GetSortedAliveCells(referenceCells);
+			if (!SameCells(aliveCells, referenceCells) ||
+				gameBoard.GetBoardHash() != referenceBoard->GetBoardHash())
+			{
+				output << "        Generation " << generation << " has " << aliveCells.size() << " cells, expected " << referenceCells.size() << std::endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 Tests::TestEngine::TestEngine()
 {
 	m_testSuites["Basic_IO"] =
 	{
 		Test("Identity", *LoadAndDiffFromDiskTest),
+		Test("Malformed", *LoadAndDiffFromDiskTest),
+		Test("MappedFileMatchesStream", *MappedFileMatchesStreamTest),
+		Test("Rle", *LoadRleAndDiffFromDiskTest),
 	};
 	m_testSuites["8x8_Board"] =
 	{
 		Test("Identity", *LoadAndDiffFromDiskTest),
 		Test("4Points", *LoadAndDiffFromDiskTest),
 		Test("VerticalLive", *LoadAndRun1GenerationAndDiffFromDiskTest),
-		Test("OneGeneration", *LoadAndRun1GenerationAndDiffFromDiskTest)
+		Test("OneGeneration", *LoadAndRun1GenerationAndDiffFromDiskTest),
+		Test("Snapshot", *LoadAndRun1GenerationThroughSnapshotAndDiffFromDiskTest),
 	};
 	m_testSuites["Big_Board"] =
 	{
@@ -281,7 +890,39 @@ Tests::TestEngine::TestEngine()
 		Test("OneGeneration", *LoadAndRun1GenerationAndDiffFromDiskTest),
 		Test("TenGeneration", *LoadAndRun15GenerationAndDiffFromDiskTest),
 		Test("OneHundredGeneration", *LoadAndRun100GenerationAndDiffFromDiskTest),
+		Test("RleGliderGun", *LoadRleAndDiffFromDiskTest),
+		Test("Snapshot", *LoadAndRun100GenerationsThroughSnapshotAndDiffFromDiskTest),
 	};
+	m_testSuites["Rules"] =
+	{
+		Test("Parse", *ParseRuleTest),
+		Test("HighLifeReplicator", *LoadAndRun12HighLifeGenerationsAndDiffFromDiskTest),
+	};
+	m_testSuites["Adaptive"] =
+	{
+		Test("SoupMatchesMultiGrid", *SoupMatchesMultiGridTest),
+	};
+
+	m_testSuites["Cycles"] =
+	{
+		Test("OscillatorsSkipToGeneration", *OscillatorsSkipToGenerationTest),
+	};
+
+	m_testSuites["Jumps"] =
+	{
+		Test("JumpsMatchMultiGrid", *JumpsMatchMultiGridTest),
+	};
+
+	m_testSuites["Tracking"] =
+	{
+		Test("PopulationAndBounds", *PopulationAndBoundsMatchCellsTest),
+	};
+
+	m_testSuites["Preallocated"] =
+	{
+		Test("BoundedSoupMatchesMultiGrid", *BoundedSoupMatchesMultiGridTest),
+	};
+
 	m_testSuites["Stress_Test"] =
 	{
 		Test("TheLine", *MakeTheLineTest),
@@ -34,6 +34,16 @@ namespace Tests
 
 		void RunMultiGridBoardTests(std::ostream& output) const;
 
+		void RunSimdGridBoardTests(std::ostream& output) const;
+
+		void RunHashLifeBoardTests(std::ostream& output) const;
+
+		void RunAdaptiveGridBoardTests(std::ostream& output) const;
+
+		void RunPreallocatedGridBoardTests(std::ostream& output) const;
+
+		void RunRuleTests(std::ostream& output) const;
+
 		void RunStressBoardTests(std::ostream& output) const;
 
 		void RunTestSuite(std::ostream& output, GameBoard::IGameBoard& gameBoard, std::string suiteName, std::optional<GameBoard::Coord> min, std::optional<GameBoard::Coord> max) const;
@@ -3,8 +3,9 @@
 #include "Input/Input.h"
 #include "Output/Output.h"
 #include "Tests/TestEngine.h"
+#include <cstring>
 
-int __cdecl main(int argc, const char* argv[])
+int main(int argc, const char* argv[])
 {
 	//If we have an argument, see if it's one we know what to do with;
 	if (argc == 2 && !strcmp(argv[1], "test"))
@@ -16,24 +17,49 @@ int __cdecl main(int argc, const char* argv[])
 			engine.RunAllTests(std::cout);
 		}
 	}
-	//Otherwise, run the default program for the test.
+	//Otherwise, run the default program for the test. A single other argument is the rule to run instead of Conway's, like B36/S23.
 	else
 	{
-		GameBoard::IGameBoardPtr multiGridBoard = GameBoard::CreateMultiGridBoard(&GameBoard::CreateStaticGridBoard6);
+		GameBoard::RuleMasks rule = Game::GameOfLifeRule();
+		if (argc == 2 && !Game::ParseRule(argv[1], rule))
+		{
+			std::cout << "Couldn't read the rule " << argv[1] << ", expected something like B3/S23" << std::endl;
+			return 1;
+		}
 
-		Input::CreateGameFromStdInput(*multiGridBoard);
+		const GameBoard::UnsignedUnit generations = 10;
+		GameBoard::IGameBoardPtr gameBoard = GameBoard::CreateAdaptiveGridBoard();
 
-		for (int i = 0; i < 10; ++i)
+		Input::CreateGameFromStdInput(*gameBoard);
+
+		//We know how many generations we're running, so if the pattern's small enough it can go on a board made to fit it exactly.
+		//Anything too spread out for that stays on the adaptive board.
+		GameBoard::Coord min, max;
+		if (gameBoard->GetBoundingBox(min, max))
 		{
-			Game::RunGameOfLifeGeneration(*multiGridBoard);
+			if (GameBoard::IGameBoardPtr preallocatedBoard = GameBoard::CreatePreallocatedGridBoard(min, max, generations))
+			{
+				std::vector<GameBoard::Coord> cells;
+				gameBoard->GetSortedAliveCells(cells);
+				preallocatedBoard->SetCells(cells, true);
+				preallocatedBoard->FinishCurrentGeneration();
+
+				gameBoard = std::move(preallocatedBoard);
+			}
 		}
 
-		Output::PrintGameBoardToStdOutput(*multiGridBoard);
-	}
+		//Builds with GOL_INSTRUMENTATION get told where the time went, everyone else gets nothing
+		GameBoard::Instrumentation::SetSummaryStream(&std::cerr, generations);
+
+		//Anything that settles down before then stops being stepped once it's been around its cycle twice
+		Game::RunGenerationsDetectingCycles(*gameBoard, rule, generations);
 
-	//Just making sure the memory leak finder works :)
-	//int* foo = new int[400];
+		Output::PrintGameBoardToStdOutput(*gameBoard);
+	}
 
-	std::cout << "Memory leaks found: " << (_CrtDumpMemoryLeaks() ? "YES" : "NO") << std::endl;
+	//Every board is gone by now, so anything still counted against one was leaked
+	const GameBoard::Memory::Usage memoryUsage = GameBoard::Memory::GetTotalUsage();
+	std::cout << "Peak board memory: " << memoryUsage.peakBytes << " bytes" << std::endl;
+	std::cout << "Memory leaks found: " << (memoryUsage.liveBytes != 0 ? "YES" : "NO") << std::endl;
 	return 0;
 }
\ No newline at end of file